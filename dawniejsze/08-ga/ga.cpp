@@ -174,7 +174,10 @@ std::vector<solution_t> crossover(const std::vector<solution_t>& solutions)
     if (cuts[0] == cuts[1]) return solutions;
     if (cuts[0] > cuts[1]) swap(cuts[0], cuts[1]);
 
-    map<int, int> taken_cities[2];
+    // the mapping of the exchanged cities, -1 if the city was not exchanged; one per thread, so it is allocated once
+    thread_local vector<int> taken_cities[2];
+    for (auto& taken : taken_cities)
+        taken.assign(solutions[0].size(), -1);
 
     for (int i = cuts[0]; i < cuts[1]; i++) {
         swap(offspring[0][i], offspring[1][i]);
@@ -187,8 +190,8 @@ std::vector<solution_t> crossover(const std::vector<solution_t>& solutions)
                 i = cuts[1] - 1;
                 continue;
             }
-            while (taken_cities[v].count(offspring[v][i])) {
-                offspring[v][i] = taken_cities[v].at(offspring[v][i]);
+            while (taken_cities[v][offspring[v][i]] >= 0) {
+                offspring[v][i] = taken_cities[v][offspring[v][i]];
             }
         }
     return offspring;
@@ -1,8 +1,10 @@
 #include <algorithm>
 #include <array>
+#include <atomic>
 #include <cassert>
 #include <chrono>
 #include <cmath>
+#include <cstdint>
 #include <fstream>
 #include <functional>
 #include <iostream>
@@ -16,7 +18,13 @@
 #include "tp_args.hpp"
 
 std::random_device rd;
-std::mt19937_64 rd_generator(rd());
+const std::uint32_t base_seed = rd();
+std::atomic<std::uint32_t> next_stream { 0 };
+// every thread has its own generator, so the parallel loops do not share its state
+thread_local std::mt19937_64 rd_generator = []() {
+    std::seed_seq seeds { base_seed, next_stream++ };
+    return std::mt19937_64(seeds);
+}();
 
 struct city_t {
     std::string name;
@@ -180,7 +188,10 @@ std::vector<solution_t> crossover(const std::vector<solution_t>& solutions)
     if (cuts[0] == cuts[1]) return solutions;
     if (cuts[0] > cuts[1]) swap(cuts[0], cuts[1]);
 
-    map<int, int> taken_cities[2];
+    // the mapping of the exchanged cities, -1 if the city was not exchanged; one per thread, so it is allocated once
+    thread_local vector<int> taken_cities[2];
+    for (auto& taken : taken_cities)
+        taken.assign(solutions[0].size(), -1);
 
     for (int i = cuts[0]; i < cuts[1]; i++) {
         swap(offspring[0][i], offspring[1][i]);
@@ -193,8 +204,8 @@ std::vector<solution_t> crossover(const std::vector<solution_t>& solutions)
                 i = cuts[1] - 1;
                 continue;
             }
-            while (taken_cities[v].count(offspring[v][i])) {
-                offspring[v][i] = taken_cities[v].at(offspring[v][i]);
+            while (taken_cities[v][offspring[v][i]] >= 0) {
+                offspring[v][i] = taken_cities[v][offspring[v][i]];
             }
         }
     return offspring;
@@ -210,14 +210,25 @@ int main(int argc, char **argv)
 
 		// to jest generowanie jednego z potomkow, aby uzyskac pare, nalezy wywolac to dwa razy
 		// z odpowiednio zamieniona kolejnoscia rodzicow
-		auto swap_part = [cpoint1, cpoint2](chromosome_t p1, chromosome_t p2) -> chromosome_t {
-			// kasujemy z rodzica numer 2 indeksy z fragmentu ciecia
+		auto swap_part = [cpoint1, cpoint2](const chromosome_t &p1, const chromosome_t &p2) -> chromosome_t {
+			// zaznaczamy miasta z fragmentu ciecia rodzica numer 1
+			vector<char> in_part(p1.size(), 0);
 			for (int i = cpoint1; i < cpoint2; i++)
-				p2.erase(std::remove(p2.begin(), p2.end(), p1.at(i)), p2.end());
-			// wstawiamy wycinany fragment na odpowiednie miejsce do potomka (ogonek sie odpowiednio przesunie)
-			p2.insert(p2.begin() + cpoint1, p1.begin() + cpoint1, p1.begin() + cpoint2);
+				in_part[p1[i]] = 1;
+			// fragment trafia na swoje miejsce w potomku, pozostale miejsca dostaja reszte rodzica numer 2 w jego kolejnosci
+			chromosome_t child(p1.size());
+			std::copy(p1.begin() + cpoint1, p1.begin() + cpoint2, child.begin() + cpoint1);
+			int k = 0;
+			for (int city : p2)
+			{
+				if (in_part[city])
+					continue;
+				if (k == cpoint1)
+					k = cpoint2;
+				child[k++] = city;
+			}
 			// zwracamy potomka
-			return p2;
+			return child;
 		};
 
 		return {swap_part(p1, p2), swap_part(p2, p1)};
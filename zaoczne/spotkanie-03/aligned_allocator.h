@@ -0,0 +1,47 @@
+#ifndef MHE_ALIGNED_ALLOCATOR_H
+#define MHE_ALIGNED_ALLOCATOR_H
+
+#include <cstddef>
+#include <new>
+#include <vector>
+
+namespace mhe {
+
+    constexpr std::size_t cache_line_size = 64;
+
+    /**
+     * Allocator that places the buffer at the beginning of a cache line, so
+     * std::vector<T, aligned_allocator<T>> can be used for hot, flat arrays.
+     */
+    template<class T, std::size_t ALIGN = cache_line_size>
+    struct aligned_allocator {
+        using value_type = T;
+
+        template<class U>
+        struct rebind {
+            using other = aligned_allocator<U, ALIGN>;
+        };
+
+        aligned_allocator() noexcept = default;
+
+        template<class U>
+        aligned_allocator(const aligned_allocator<U, ALIGN> &) noexcept {}
+
+        T *allocate(std::size_t n) {
+            return static_cast<T *>(::operator new(n * sizeof(T), std::align_val_t(ALIGN)));
+        }
+
+        void deallocate(T *p, std::size_t) noexcept {
+            ::operator delete(p, std::align_val_t(ALIGN));
+        }
+
+        template<class U>
+        bool operator==(const aligned_allocator<U, ALIGN> &) const noexcept { return true; }
+    };
+
+    template<class T>
+    using aligned_vector = std::vector<T, aligned_allocator<T>>;
+
+} // mhe
+
+#endif //MHE_ALIGNED_ALLOCATOR_H
@@ -0,0 +1,308 @@
+#include "branch_and_bound.h"
+
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+#include <limits>
+#include <mutex>
+#include <numeric>
+#include <type_traits>
+#include <utility>
+
+namespace mhe {
+
+    namespace {
+        const double bound_eps = 1e-9;
+        const double infinity = std::numeric_limits<double>::infinity();
+
+        enum edge_state_t : signed char {
+            excluded_edge = -1, free_edge = 0, forced_edge = 1
+        };
+
+        struct node_t {
+            std::vector<signed char> edges; ///< edge_state_t of every pair of cities, n x n
+            std::vector<double> pi; ///< the city penalties from the parent
+            double bound; ///< the bound of the parent, it holds for the whole subtree
+            int depth;
+        };
+
+        /// the minimum 1-tree: the spanning tree of 1 .. n - 1 and two edges of the city 0
+        struct one_tree_t {
+            double value; ///< the lower bound, infinity if there is no 1-tree with the fixed edges
+            std::vector<int> parent; ///< in the tree of 1 .. n - 1, -1 for the city 1
+            int first; ///< the neighbours of the city 0
+            int second;
+            std::vector<int> degree;
+        };
+
+        class branch_and_bound_t {
+        public:
+            template<class PROBLEM>
+            branch_and_bound_t(const PROBLEM &problem, const std::vector<int> &initial_tour,
+                               const branch_and_bound_config_t &config_) :
+                    n(problem.size()), cost(n * n), config(config_), best_tour(initial_tour) {
+                integral = std::is_integral_v<typename PROBLEM::distance_type>;
+                for (int i = 0; i < n; i++)
+                    for (int j = 0; j < n; j++) cost[i * n + j] = problem.distance(i, j);
+                best_length = tour_length(best_tour);
+            }
+
+            branch_and_bound_result_t run() {
+                node_t root{std::vector<signed char>(n * n, free_edge), std::vector<double>(n, 0.0), -infinity, 0};
+                for (int i = 0; i < n; i++) root.edges[i * n + i] = excluded_edge;
+#pragma omp parallel
+#pragma omp single
+                process(std::move(root));
+                double length = best_length;
+                double lower_bound = std::min(length, integral ? std::ceil(open_bound - bound_eps) : open_bound.load());
+                return {best_tour, length, std::min(root_bound, length), lower_bound, std::min(nodes.load(), config.node_limit)};
+            }
+
+        private:
+            const int n;
+            std::vector<double> cost;
+            bool integral;
+            const branch_and_bound_config_t &config;
+
+            std::atomic<double> best_length;
+            std::mutex best_tour_mutex;
+            std::vector<int> best_tour;
+
+            std::atomic<long> nodes{0};
+            std::atomic<double> open_bound{infinity}; ///< the lowest bound of the subtrees left by node_limit
+            double root_bound = -infinity;
+
+            double tour_length(const std::vector<int> &tour) const {
+                double length = 0;
+                for (int i = 0; i < tour.size(); i++) length += cost[tour[i] * n + tour[(i + 1) % tour.size()]];
+                return length;
+            }
+
+            /// no tour in the subtree can be shorter than the best one
+            bool prunable(double bound) const {
+                if (integral) bound = std::ceil(bound - bound_eps);
+                return bound >= best_length.load() - bound_eps;
+            }
+
+            void offer(const std::vector<int> &tour) {
+                double length = tour_length(tour);
+                if (length >= best_length.load()) return;
+                std::lock_guard<std::mutex> lock(best_tour_mutex);
+                if (length >= best_length.load()) return;
+                best_tour = tour;
+                best_length = length;
+            }
+
+            static void atomic_min(std::atomic<double> &value, double candidate) {
+                double current = value.load();
+                while ((candidate < current) && !value.compare_exchange_weak(current, candidate));
+            }
+
+            void compute_one_tree(const node_t &node, const std::vector<double> &pi, one_tree_t &tree) const {
+                auto weight = [&](int i, int j) { return cost[i * n + j] + pi[i] + pi[j]; };
+                auto state = [&](int i, int j) { return node.edges[i * n + j]; };
+                tree.value = infinity;
+                tree.parent.assign(n, -1);
+                tree.degree.assign(n, 0);
+                // Prim from the city 1; the forced edges go first, the excluded ones are never taken
+                std::vector<std::pair<int, double>> key(n, {2, infinity});
+                std::vector<bool> in_tree(n, false);
+                in_tree[0] = true;
+                key[1] = {0, 0.0};
+                double value = 0;
+                int forced_in_tree = 0;
+                for (int step = 1; step < n; step++) {
+                    int v = -1;
+                    for (int u = 1; u < n; u++)
+                        if (!in_tree[u] && ((v < 0) || (key[u] < key[v]))) v = u;
+                    if (key[v].first == 2) return;
+                    in_tree[v] = true;
+                    if (tree.parent[v] >= 0) {
+                        value += key[v].second;
+                        tree.degree[v]++;
+                        tree.degree[tree.parent[v]]++;
+                        if (key[v].first == 0) forced_in_tree++;
+                    }
+                    for (int u = 1; u < n; u++) {
+                        if (in_tree[u] || (state(v, u) == excluded_edge)) continue;
+                        std::pair<int, double> k = {(state(v, u) == forced_edge) ? 0 : 1, weight(v, u)};
+                        if (k < key[u]) {
+                            key[u] = k;
+                            tree.parent[u] = v;
+                        }
+                    }
+                }
+                // a forced edge that is not in the tree closes a cycle without the city 0
+                int forced = 0;
+                for (int i = 1; i < n; i++)
+                    for (int j = i + 1; j < n; j++) forced += (state(i, j) == forced_edge);
+                if (forced_in_tree < forced) return;
+                // the two edges of the city 0, the forced ones first (force() allows at most two)
+                std::pair<int, double> best[2] = {{2, infinity}, {2, infinity}};
+                int ends[2] = {-1, -1};
+                for (int u = 1; u < n; u++) {
+                    if (state(0, u) == excluded_edge) continue;
+                    std::pair<int, double> k = {(state(0, u) == forced_edge) ? 0 : 1, weight(0, u)};
+                    if (k < best[1]) {
+                        best[1] = k;
+                        ends[1] = u;
+                        if (best[1] < best[0]) {
+                            std::swap(best[0], best[1]);
+                            std::swap(ends[0], ends[1]);
+                        }
+                    }
+                }
+                if (ends[1] < 0) return;
+                tree.first = ends[0];
+                tree.second = ends[1];
+                tree.degree[0] = 2;
+                tree.degree[ends[0]]++;
+                tree.degree[ends[1]]++;
+                value += best[0].second + best[1].second;
+                tree.value = value - 2 * std::accumulate(pi.begin(), pi.end(), 0.0);
+            }
+
+            /// the 1-tree with every degree 2 is a tour
+            std::vector<int> tour_of(const one_tree_t &tree) const {
+                std::vector<std::vector<int>> neighbours(n);
+                auto link = [&](int a, int b) {
+                    neighbours[a].push_back(b);
+                    neighbours[b].push_back(a);
+                };
+                for (int v = 1; v < n; v++)
+                    if (tree.parent[v] >= 0) link(v, tree.parent[v]);
+                link(0, tree.first);
+                link(0, tree.second);
+                std::vector<int> tour = {0};
+                for (int previous = 0, city = tree.first; city != 0;) {
+                    tour.push_back(city);
+                    int next = (neighbours[city][0] != previous) ? neighbours[city][0] : neighbours[city][1];
+                    previous = city;
+                    city = next;
+                }
+                return tour;
+            }
+
+            /// forces the edge; a city with two forced edges has all its other edges excluded
+            bool force(node_t &node, int a, int b) const {
+                node.edges[a * n + b] = node.edges[b * n + a] = forced_edge;
+                for (int x: {a, b}) {
+                    int forced = 0;
+                    for (int y = 0; y < n; y++) forced += (node.edges[x * n + y] == forced_edge);
+                    if (forced > 2) return false;
+                    if (forced < 2) continue;
+                    for (int y = 0; y < n; y++)
+                        if (node.edges[x * n + y] == free_edge) node.edges[x * n + y] = node.edges[y * n + x] = excluded_edge;
+                }
+                return true;
+            }
+
+            void exclude(node_t &node, int a, int b) const {
+                node.edges[a * n + b] = node.edges[b * n + a] = excluded_edge;
+            }
+
+            void process(node_t node) {
+                if (nodes++ >= config.node_limit) {
+                    atomic_min(open_bound, node.bound);
+                    return;
+                }
+                if (prunable(node.bound)) return;
+
+                // subgradient steps on the penalties, the best bound is kept
+                one_tree_t tree;
+                std::vector<double> pi = node.pi;
+                std::vector<double> best_pi = pi;
+                double best_value = -infinity;
+                const int iterations = (node.depth == 0) ? config.root_iterations : config.node_iterations;
+                double lambda = (node.depth == 0) ? 2.0 : 0.5;
+                const int period = (node.depth == 0) ? std::max(10, n / 2) : 5;
+                for (int it = 0, stalled = 0; it < std::max(1, iterations); it++) {
+                    compute_one_tree(node, pi, tree);
+                    if (tree.value == infinity) return;
+                    if (tree.value > best_value) {
+                        best_value = tree.value;
+                        best_pi = pi;
+                        stalled = 0;
+                        if (node.depth == 0) root_bound = best_value;
+                    } else if (++stalled >= period) {
+                        lambda /= 2;
+                        stalled = 0;
+                    }
+                    if (prunable(best_value)) return;
+                    int norm = 0;
+                    for (int d: tree.degree) norm += (d - 2) * (d - 2);
+                    if (norm == 0) {
+                        offer(tour_of(tree));
+                        return;
+                    }
+                    double step = lambda * (best_length.load() - tree.value) / norm;
+                    for (int i = 0; i < n; i++) pi[i] += step * (tree.degree[i] - 2);
+                }
+                compute_one_tree(node, best_pi, tree);
+
+                // the city with the most tree edges, and its two shortest free tree edges
+                int v = std::max_element(tree.degree.begin(), tree.degree.end()) - tree.degree.begin();
+                std::vector<int> free_edges;
+                for (int u = 0; u < n; u++) {
+                    bool in_tree = (tree.parent[u] == v) || ((u > 0) && (tree.parent[v] == u)) ||
+                                   ((v == 0) && ((u == tree.first) || (u == tree.second))) ||
+                                   ((u == 0) && ((v == tree.first) || (v == tree.second)));
+                    if (in_tree && (node.edges[v * n + u] == free_edge)) free_edges.push_back(u);
+                }
+                std::sort(free_edges.begin(), free_edges.end(),
+                          [&](int a, int b) { return cost[v * n + a] < cost[v * n + b]; });
+                int forced = 0;
+                for (int u = 0; u < n; u++) forced += (node.edges[v * n + u] == forced_edge);
+
+                std::vector<node_t> children;
+                auto child = [&]() { return node_t{node.edges, best_pi, best_value, node.depth + 1}; };
+                const int e1 = free_edges[0];
+                children.push_back(child());
+                exclude(children.back(), v, e1);
+                if ((forced == 0) && (free_edges.size() >= 2)) {
+                    const int e2 = free_edges[1];
+                    children.push_back(child());
+                    exclude(children.back(), v, e2);
+                    if (!force(children.back(), v, e1)) children.pop_back();
+                    children.push_back(child());
+                    if (!force(children.back(), v, e1) || !force(children.back(), v, e2)) children.pop_back();
+                } else {
+                    children.push_back(child());
+                    if (!force(children.back(), v, e1)) children.pop_back();
+                }
+                for (auto &c: children) {
+                    if (node.depth < config.parallel_depth) {
+                        node_t task_node = std::move(c);
+#pragma omp task firstprivate(task_node)
+                        process(std::move(task_node));
+                    } else {
+                        process(std::move(c));
+                    }
+                }
+            }
+        };
+    }
+
+    template<class PROBLEM>
+    branch_and_bound_result_t branch_and_bound(const PROBLEM &problem, const std::vector<int> &initial_tour,
+                                               const branch_and_bound_config_t &config) {
+        std::vector<int> tour = initial_tour;
+        if (tour.size() != problem.size()) {
+            tour.resize(problem.size());
+            std::iota(tour.begin(), tour.end(), 0);
+        }
+        if (problem.size() <= 3) {
+            double length = 0;
+            for (int i = 0; i < tour.size(); i++) length += problem.distance(tour[i], tour[(i + 1) % tour.size()]);
+            return {tour, length, length, length, 1};
+        }
+        branch_and_bound_t search(problem, tour, config);
+        return search.run();
+    }
+
+    template branch_and_bound_result_t branch_and_bound(const problem_t &, const std::vector<int> &,
+                                                        const branch_and_bound_config_t &);
+    template branch_and_bound_result_t branch_and_bound(const tsplib_problem_t &, const std::vector<int> &,
+                                                        const branch_and_bound_config_t &);
+
+} // mhe
@@ -0,0 +1,58 @@
+#ifndef MHE_BRANCH_AND_BOUND_H
+#define MHE_BRANCH_AND_BOUND_H
+
+#include "problem_t.h"
+
+#include <vector>
+
+namespace mhe {
+
+    /// limits of branch_and_bound
+    struct branch_and_bound_config_t {
+        long node_limit = 10000000; ///< after that many nodes the search stops with a gap
+        int root_iterations = 1000; ///< subgradient iterations for the root bound
+        int node_iterations = 30; ///< subgradient iterations in every other node
+        int parallel_depth = 8; ///< the nodes up to this depth are OpenMP tasks
+    };
+
+    struct branch_and_bound_result_t {
+        std::vector<int> tour; ///< the best tour that was found
+        double length; ///< its length
+        double root_bound; ///< the Held-Karp bound of the root
+        double lower_bound; ///< the proven bound, length when the tour is optimal
+        long nodes; ///< the number of processed nodes
+
+        bool optimal() const { return lower_bound >= length; }
+
+        /// (length - lower_bound) / lower_bound, 0 for the proven optimum
+        double gap() const { return optimal() ? 0.0 : (length - lower_bound) / lower_bound; }
+    };
+
+    /**
+     * Exact branch and bound. Every node is bounded by the Held-Karp 1-tree: the minimum
+     * spanning tree of the cities 1 .. n - 1 and the two shortest edges of city 0, with
+     * the city penalties optimised by subgradient steps. The penalties are inherited by
+     * the children, so the nodes need only a few steps. The branching is on the edges of
+     * a city with more than two tree edges: exclude the first, force it and exclude the
+     * second, or force both.
+     *
+     * The tree is searched depth first by OpenMP tasks, the idle threads take the
+     * pending subtrees. The length of the best tour is an atomic, so the threads prune
+     * with it without locking; only a better tour itself is stored under a lock.
+     *
+     * initial_tour is the incumbent at the start, it should come from a good heuristic.
+     * If node_limit is reached, the result has the best tour and the bound of the
+     * subtrees that were left.
+     */
+    template<class PROBLEM>
+    branch_and_bound_result_t branch_and_bound(const PROBLEM &problem, const std::vector<int> &initial_tour,
+                                               const branch_and_bound_config_t &config = {});
+
+    extern template branch_and_bound_result_t branch_and_bound(const problem_t &, const std::vector<int> &,
+                                                               const branch_and_bound_config_t &);
+    extern template branch_and_bound_result_t branch_and_bound(const tsplib_problem_t &, const std::vector<int> &,
+                                                               const branch_and_bound_config_t &);
+
+} // mhe
+
+#endif //MHE_BRANCH_AND_BOUND_H
@@ -0,0 +1,152 @@
+#include "checkpoint.h"
+#include "mapped_file.h"
+
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <stdexcept>
+
+namespace mhe {
+
+    namespace {
+        const char checkpoint_magic[8] = {'M', 'H', 'E', 'C', 'K', 'P', 'T', '\0'};
+
+        struct header_t {
+            char magic[8];
+            std::uint32_t version;
+            std::uint32_t edge_weight_type;
+            std::uint32_t integer_distances;
+            std::uint32_t reserved;
+            std::uint64_t name_length;
+            std::uint64_t cities;
+            std::uint64_t weights;
+            std::uint64_t population_size;
+            std::uint64_t iteration;
+            std::uint64_t seed;
+        };
+
+        template<class T>
+        void write_array(std::ofstream &out, const T *data, std::size_t count) {
+            out.write(reinterpret_cast<const char *>(data), count * sizeof(T));
+        }
+
+        /// the sections of the mapped file, every read is checked against its end
+        class reader_t {
+        public:
+            reader_t(const char *begin, const char *end_, const std::string &file_name_) :
+                    p(begin), end(end_), file_name(file_name_) {}
+
+            template<class T>
+            void read(T *data, std::size_t count) {
+                if ((end - p) / sizeof(T) < count) throw std::invalid_argument(file_name + " is truncated");
+                if (count == 0) return; // empty sections, e.g. the weights of EUC_2D, may have no buffer
+                std::memcpy(data, p, count * sizeof(T));
+                p += count * sizeof(T);
+            }
+
+        private:
+            const char *p;
+            const char *end;
+            const std::string &file_name;
+        };
+    }
+
+    void save_checkpoint(const std::string &file_name, const checkpoint_t &checkpoint) {
+        const problem_file_t &problem = *checkpoint.problem;
+        header_t header{};
+        std::memcpy(header.magic, checkpoint_magic, sizeof(header.magic));
+        header.version = checkpoint_version;
+        header.edge_weight_type = (std::uint32_t) problem.edge_weight_type;
+        header.integer_distances = checkpoint.integer_distances;
+        header.name_length = problem.name.size();
+        header.cities = problem.cities.size();
+        header.weights = problem.weights.size();
+        header.population_size = checkpoint.goals.size();
+        header.iteration = checkpoint.iteration;
+        header.seed = checkpoint.seed;
+        if (checkpoint.population.size() != header.population_size * header.cities)
+            throw std::invalid_argument("the checkpoint population does not match the number of cities");
+
+        const std::string temporary = file_name + ".tmp";
+        {
+            std::ofstream out(temporary, std::ios::binary | std::ios::trunc);
+            write_array(out, &header, 1);
+            write_array(out, problem.name.data(), problem.name.size());
+            write_array(out, problem.cities.data(), problem.cities.size());
+            write_array(out, problem.weights.data(), problem.weights.size());
+            write_array(out, checkpoint.population.data(), checkpoint.population.size());
+            write_array(out, checkpoint.goals.data(), checkpoint.goals.size());
+            if (!out.flush()) throw std::invalid_argument("could not write " + temporary);
+        }
+        if (std::rename(temporary.c_str(), file_name.c_str()) != 0)
+            throw std::invalid_argument("could not rename " + temporary + " to " + file_name);
+    }
+
+    checkpoint_t load_checkpoint(const std::string &file_name) {
+        mapped_file_t mapped(file_name);
+        reader_t in(mapped.begin(), mapped.end(), file_name);
+        header_t header;
+        in.read(&header, 1);
+        if (std::memcmp(header.magic, checkpoint_magic, sizeof(header.magic)) != 0)
+            throw std::invalid_argument(file_name + " is not a checkpoint");
+        if (header.version != checkpoint_version)
+            throw std::invalid_argument(file_name + " has the checkpoint version " + std::to_string(header.version));
+        if (header.edge_weight_type > (std::uint32_t) edge_weight_t::explicit_matrix)
+            throw std::invalid_argument(file_name + " has a wrong edge weight type");
+        if (header.integer_distances > 1)
+            throw std::invalid_argument(file_name + " has a wrong metric");
+        if (header.population_size == 0)
+            throw std::invalid_argument(file_name + " has an empty population");
+        // the sizes are checked against the file before anything is allocated
+        if ((header.name_length > mapped.size()) || (header.cities > mapped.size() / sizeof(vec2d)) ||
+            (header.weights > mapped.size() / sizeof(std::int32_t)) ||
+            ((header.cities != 0) && (header.population_size > mapped.size() / header.cities)) ||
+            (header.population_size > mapped.size() / sizeof(double)))
+            throw std::invalid_argument(file_name + " is truncated");
+        // compared by the division, cities * cities could overflow
+        if ((header.weights != 0) && ((header.cities == 0) || (header.weights % header.cities != 0) ||
+                                      (header.weights / header.cities != header.cities)))
+            throw std::invalid_argument(file_name + " has a wrong distance matrix size");
+
+        auto problem = std::make_shared<problem_file_t>();
+        problem->edge_weight_type = (edge_weight_t) header.edge_weight_type;
+        problem->name.resize(header.name_length);
+        in.read(problem->name.data(), problem->name.size());
+        problem->cities.resize(header.cities);
+        in.read(problem->cities.data(), problem->cities.size());
+        problem->weights.resize(header.weights);
+        in.read(problem->weights.data(), problem->weights.size());
+
+        checkpoint_t checkpoint;
+        checkpoint.problem = problem;
+        checkpoint.iteration = header.iteration;
+        checkpoint.seed = header.seed;
+        checkpoint.integer_distances = header.integer_distances;
+        checkpoint.population.resize(header.population_size * header.cities);
+        in.read(checkpoint.population.data(), checkpoint.population.size());
+        checkpoint.goals.resize(header.population_size);
+        in.read(checkpoint.goals.data(), checkpoint.goals.size());
+        // every tour must be a permutation, the crossovers loop forever on a repeated city
+        std::vector<std::uint64_t> seen(header.cities, 0);
+        for (std::uint64_t i = 0; i < checkpoint.population.size(); i++) {
+            const auto city = checkpoint.population[i];
+            const std::uint64_t tour = i / header.cities + 1;
+            if ((city < 0) || (city >= header.cities) || (seen[city] == tour))
+                throw std::invalid_argument(file_name + " has a wrong tour");
+            seen[city] = tour;
+        }
+        return checkpoint;
+    }
+
+    void checkpoint_writer_t::write(checkpoint_t checkpoint) {
+        wait();
+        pending = std::async(std::launch::async, [this, checkpoint = std::move(checkpoint)]() {
+            save_checkpoint(file_name, checkpoint);
+        });
+    }
+
+    void checkpoint_writer_t::wait() {
+        if (pending.valid()) pending.get();
+    }
+
+} // mhe
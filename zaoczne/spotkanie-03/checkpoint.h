@@ -0,0 +1,73 @@
+#ifndef MHE_CHECKPOINT_H
+#define MHE_CHECKPOINT_H
+
+#include "problem_file.h"
+
+#include <cstdint>
+#include <future>
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace mhe {
+
+    /// the format version written by save_checkpoint; load_checkpoint rejects the other ones
+    constexpr std::uint32_t checkpoint_version = 4;
+
+    /**
+     * The state of the genetic algorithm after a generation. With the same parameters
+     * the run continues from it exactly as it would without the break.
+     */
+    struct checkpoint_t {
+        /// EUC_2D coordinates, or the full integer matrix of the other edge weight types
+        std::shared_ptr<const problem_file_t> problem;
+        std::uint64_t iteration = 0;
+        /// the tours of the population, problem->cities.size() cities each, one after another
+        std::vector<std::int32_t> population;
+        /// the goal of every tour, the resumed run computes them again from the tours
+        std::vector<double> goals;
+        /// of the counter_rng_t generators, they continue from the generation iteration
+        std::uint64_t seed = 0;
+        /// the goals are the TSPLIB integer tour lengths (-integer_distances), the resumed run uses the same metric
+        bool integer_distances = false;
+    };
+
+    /**
+     * Writes the binary snapshot: the header (magic, version, metric, sizes), the name, the
+     * coordinates, the matrix, the tours as int32 and the goals as double, in the native
+     * byte order. It goes to file_name.tmp first and is renamed,
+     * so an interrupted write leaves the previous snapshot. Throws std::invalid_argument.
+     */
+    void save_checkpoint(const std::string &file_name, const checkpoint_t &checkpoint);
+
+    /// reads the snapshot from the memory mapped file, throws std::invalid_argument if it is not valid
+    checkpoint_t load_checkpoint(const std::string &file_name);
+
+    /**
+     * Saves the snapshots in the background, so the search does not wait for the disk.
+     * A snapshot waits only for the previous one to be written.
+     */
+    class checkpoint_writer_t {
+    public:
+        explicit checkpoint_writer_t(std::string file_name_) : file_name(std::move(file_name_)) {}
+
+        checkpoint_writer_t(const checkpoint_writer_t &) = delete;
+        checkpoint_writer_t &operator=(const checkpoint_writer_t &) = delete;
+
+        ~checkpoint_writer_t() {
+            if (pending.valid()) pending.wait();
+        }
+
+        void write(checkpoint_t checkpoint);
+
+        /// waits for the snapshot that is being written, and rethrows its error
+        void wait();
+
+    private:
+        std::string file_name;
+        std::future<void> pending;
+    };
+
+} // mhe
+
+#endif //MHE_CHECKPOINT_H
@@ -0,0 +1,308 @@
+#include "construction.h"
+
+#include "kd_tree.h"
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <cstdint>
+#include <limits>
+#include <numbers>
+#include <numeric>
+#include <optional>
+#include <utility>
+
+namespace mhe {
+
+    namespace {
+        /**
+         * The cities that are left, with the nearest city queries by problem.distance.
+         * Without the distance matrix they are in kd_tree_t. With the matrix they are in
+         * an array (removed by swapping with the last one), the first ones that are left
+         * on the candidate list of the city are the nearest, and only if there are too
+         * few of them all the cities that are left are checked. Removing a city twice does
+         * nothing, as in kd_tree_t.
+         */
+        template<class PROBLEM>
+        class remaining_cities_t {
+        public:
+            explicit remaining_cities_t(const PROBLEM &problem_) : problem(problem_) {
+                const int n = problem.size();
+                if (!problem.distances) {
+                    tree.emplace(problem);
+                    return;
+                }
+                cities.resize(n);
+                position.resize(n);
+                std::iota(cities.begin(), cities.end(), 0);
+                std::iota(position.begin(), position.end(), 0);
+            }
+
+            void remove(int city) {
+                if (tree) return tree->remove(city);
+                if (position[city] < 0) return;
+                const int last = cities.back();
+                cities[position[city]] = last;
+                position[last] = position[city];
+                position[city] = -1;
+                cities.pop_back();
+            }
+
+            /// -1 when no city is left
+            int nearest(int from) {
+                if (tree) return tree->nearest(problem[from]);
+                k_nearest(from, 1, found);
+                return found.empty() ? -1 : found[0];
+            }
+
+            /// up to k cities that are left, nearest to from, sorted by the distance
+            void k_nearest(int from, int k, std::vector<int> &result) {
+                if (tree) return tree->k_nearest(problem[from], k, -1, result);
+                result.clear();
+                if (problem.candidates) {
+                    auto &candidates = *problem.candidates;
+                    for (auto it = candidates.begin(from); (it != candidates.end(from)) && (result.size() < k); ++it)
+                        if (position[*it] >= 0) result.push_back(*it);
+                }
+                if ((result.size() == k) || (result.size() == cities.size())) return;
+                // the candidates are not enough, the k nearest of all the cities that are left
+                result.clear();
+                for (int city: cities) {
+                    auto closer = [&](int a, int b) { return problem.distance(from, a) < problem.distance(from, b); };
+                    if ((result.size() == k) && !closer(city, result.back())) continue;
+                    if (result.size() == k) result.pop_back();
+                    result.insert(std::upper_bound(result.begin(), result.end(), city, closer), city);
+                }
+            }
+
+        private:
+            const PROBLEM &problem;
+            std::optional<kd_tree_t> tree;
+            std::vector<int> cities;
+            std::vector<int> position; ///< in cities, -1 if removed
+            std::vector<int> found;
+        };
+    }
+
+    template<class PROBLEM>
+    std::vector<int> nearest_neighbour_tour(const PROBLEM &problem, int start) {
+        std::vector<int> tour;
+        if (problem.empty()) return tour;
+        tour.reserve(problem.size());
+        remaining_cities_t unvisited(problem);
+        for (int city = start; city >= 0;) {
+            tour.push_back(city);
+            unvisited.remove(city);
+            city = unvisited.nearest(city);
+        }
+        return tour;
+    }
+
+    template<class PROBLEM>
+    std::vector<int> randomized_nearest_neighbour_tour(const PROBLEM &problem, int start, double noise,
+                                                       std::mt19937 &rgen) {
+        const int breadth = 3;
+        std::vector<int> tour;
+        if (problem.empty()) return tour;
+        tour.reserve(problem.size());
+        remaining_cities_t unvisited(problem);
+        std::uniform_real_distribution<double> u(0.0, 1.0);
+        std::vector<int> nearest;
+        int city = start;
+        while (city >= 0) {
+            tour.push_back(city);
+            unvisited.remove(city);
+            if (u(rgen) < noise) {
+                unvisited.k_nearest(city, breadth, nearest);
+                if (nearest.empty()) break;
+                // the nearest one only when it is the last city left
+                const int first = (nearest.size() > 1) ? 1 : 0;
+                city = nearest[std::uniform_int_distribution<int>(first, nearest.size() - 1)(rgen)];
+            } else {
+                city = unvisited.nearest(city);
+            }
+        }
+        return tour;
+    }
+
+    namespace {
+        /// the position of the cell (x, y) on the Hilbert curve that fills 2^order x 2^order cells
+        std::uint64_t hilbert_key(std::uint32_t x, std::uint32_t y, int order) {
+            const std::uint32_t side = std::uint32_t(1) << order;
+            std::uint64_t key = 0;
+            for (std::uint32_t s = side / 2; s > 0; s /= 2) {
+                std::uint32_t rx = (x & s) ? 1 : 0;
+                std::uint32_t ry = (y & s) ? 1 : 0;
+                key += std::uint64_t(s) * s * ((3 * rx) ^ ry);
+                if (ry == 0) {
+                    if (rx == 1) {
+                        x = side - 1 - x;
+                        y = side - 1 - y;
+                    }
+                    std::swap(x, y);
+                }
+            }
+            return key;
+        }
+
+        struct union_find_t {
+            std::vector<int> parent;
+            std::vector<int> size;
+
+            explicit union_find_t(int n) : parent(n), size(n, 1) {
+                std::iota(parent.begin(), parent.end(), 0);
+            }
+
+            int find(int a) {
+                while (parent[a] != a) a = parent[a] = parent[parent[a]];
+                return a;
+            }
+
+            bool unite(int a, int b) {
+                a = find(a);
+                b = find(b);
+                if (a == b) return false;
+                if (size[a] < size[b]) std::swap(a, b);
+                parent[b] = a;
+                size[a] += size[b];
+                return true;
+            }
+        };
+
+        /// greedy edge, with the noise only if there is rgen
+        template<class PROBLEM>
+        std::vector<int> build_greedy_edge_tour(const PROBLEM &problem, const candidate_lists_t &candidates,
+                                                double noise, std::mt19937 *rgen) {
+            const int n = problem.size();
+            std::vector<int> tour;
+            if (n == 0) return tour;
+            std::uniform_real_distribution<double> u(0.0, noise);
+            std::vector<std::pair<double, std::pair<int, int>>> edges;
+            edges.reserve(n * candidates.k);
+            for (int a = 0; a < n; a++) {
+                for (auto it = candidates.begin(a); it != candidates.end(a); ++it) {
+                    double length = problem.distance(a, *it);
+                    if (rgen) length *= 1.0 + u(*rgen);
+                    edges.push_back({length, {a, *it}});
+                }
+            }
+            std::sort(edges.begin(), edges.end());
+
+            // the neighbours of every city in the fragments, -1 when there is none
+            std::vector<std::array<int, 2>> links(n, {-1, -1});
+            union_find_t fragments(n);
+            for (auto &[length, edge]: edges) {
+                auto [a, b] = edge;
+                if ((links[a][1] >= 0) || (links[b][1] >= 0) || !fragments.unite(a, b)) continue;
+                links[a][(links[a][0] >= 0) ? 1 : 0] = b;
+                links[b][(links[b][0] >= 0) ? 1 : 0] = a;
+            }
+
+            // only the free ends of the fragments stay in the tree
+            remaining_cities_t ends(problem);
+            int start = -1;
+            for (int a = 0; a < n; a++) {
+                if (links[a][1] >= 0) ends.remove(a);
+                else if (start < 0) start = a;
+            }
+            tour.reserve(n);
+            for (int city = start; city >= 0; city = ends.nearest(city)) {
+                // walk the whole fragment, then jump to the nearest free end
+                ends.remove(city);
+                for (int previous = -1, next; city >= 0; previous = city, city = next) {
+                    tour.push_back(city);
+                    next = (links[city][0] != previous) ? links[city][0] : links[city][1];
+                    if (next < 0) ends.remove(city);
+                }
+                city = tour.back();
+            }
+            return tour;
+        }
+    }
+
+    std::vector<int> hilbert_curve_tour(const std::vector<vec2d> &cities, double angle) {
+        const int order = 16;
+        const int n = cities.size();
+        std::vector<vec2d> rotated(n);
+        const double c = std::cos(angle);
+        const double s = std::sin(angle);
+        vec2d low = {std::numeric_limits<double>::max(), std::numeric_limits<double>::max()};
+        vec2d high = {std::numeric_limits<double>::lowest(), std::numeric_limits<double>::lowest()};
+        for (int i = 0; i < n; i++) {
+            rotated[i] = {c * cities[i][0] - s * cities[i][1], s * cities[i][0] + c * cities[i][1]};
+            for (int d = 0; d < 2; d++) {
+                low[d] = std::min(low[d], rotated[i][d]);
+                high[d] = std::max(high[d], rotated[i][d]);
+            }
+        }
+        // the same scale on both axes, so the curve is not stretched
+        const double cells = (std::uint32_t(1) << order) - 1;
+        const double scale = cells / std::max({high[0] - low[0], high[1] - low[1], 1e-300});
+        std::vector<std::pair<std::uint64_t, int>> keys(n);
+        for (int i = 0; i < n; i++) {
+            auto x = (std::uint32_t) ((rotated[i][0] - low[0]) * scale);
+            auto y = (std::uint32_t) ((rotated[i][1] - low[1]) * scale);
+            keys[i] = {hilbert_key(x, y, order), i};
+        }
+        std::sort(keys.begin(), keys.end());
+        std::vector<int> tour(n);
+        for (int i = 0; i < n; i++) tour[i] = keys[i].second;
+        return tour;
+    }
+
+    template<class PROBLEM>
+    std::vector<int> greedy_edge_tour(const PROBLEM &problem, const candidate_lists_t &candidates) {
+        return build_greedy_edge_tour(problem, candidates, 0.0, nullptr);
+    }
+
+    template<class PROBLEM>
+    std::vector<int> greedy_edge_tour(const PROBLEM &problem, const candidate_lists_t &candidates,
+                                      double noise, std::mt19937 &rgen) {
+        return build_greedy_edge_tour(problem, candidates, noise, &rgen);
+    }
+
+    template<class PROBLEM>
+    std::vector<std::vector<int>> seed_population(const PROBLEM &problem, const candidate_lists_t &candidates,
+                                                  int count, const seeding_t &seeding, std::mt19937 &rgen) {
+        const int n = problem.size();
+        const int hilbert_end = std::lround(count * seeding.hilbert);
+        const int greedy_end = hilbert_end + std::lround(count * seeding.greedy);
+        const int nearest_neighbour_end = greedy_end + std::lround(count * seeding.nearest_neighbour);
+        std::vector<std::mt19937::result_type> seeds(count);
+        for (auto &seed: seeds) seed = rgen();
+        std::vector<std::vector<int>> population(count);
+#pragma omp parallel for schedule(dynamic, 1)
+        for (int i = 0; i < count; i++) {
+            std::mt19937 individual_rgen(seeds[i]);
+            std::uniform_int_distribution<int> city(0, n - 1);
+            if (i < hilbert_end) {
+                // the first one is the plain curve, the others are rotated
+                double angle = (i == 0) ? 0.0 : std::uniform_real_distribution<double>(0.0, 2 * std::numbers::pi)(individual_rgen);
+                population[i] = hilbert_curve_tour(problem, angle);
+            } else if (i < greedy_end) {
+                double noise = (i == hilbert_end) ? 0.0 : seeding.noise;
+                population[i] = greedy_edge_tour(problem, candidates, noise, individual_rgen);
+            } else if (i < nearest_neighbour_end) {
+                population[i] = randomized_nearest_neighbour_tour(problem, city(individual_rgen), seeding.noise,
+                                                                  individual_rgen);
+            } else {
+                population[i].resize(n);
+                std::iota(population[i].begin(), population[i].end(), 0);
+                std::shuffle(population[i].begin(), population[i].end(), individual_rgen);
+            }
+        }
+        return population;
+    }
+
+    template std::vector<int> nearest_neighbour_tour(const problem_t &, int);
+    template std::vector<int> nearest_neighbour_tour(const tsplib_problem_t &, int);
+    template std::vector<int> randomized_nearest_neighbour_tour(const problem_t &, int, double, std::mt19937 &);
+    template std::vector<int> randomized_nearest_neighbour_tour(const tsplib_problem_t &, int, double, std::mt19937 &);
+    template std::vector<int> greedy_edge_tour(const problem_t &, const candidate_lists_t &);
+    template std::vector<int> greedy_edge_tour(const tsplib_problem_t &, const candidate_lists_t &);
+    template std::vector<int> greedy_edge_tour(const problem_t &, const candidate_lists_t &, double, std::mt19937 &);
+    template std::vector<int> greedy_edge_tour(const tsplib_problem_t &, const candidate_lists_t &, double, std::mt19937 &);
+    template std::vector<std::vector<int>> seed_population(const problem_t &, const candidate_lists_t &, int, const seeding_t &, std::mt19937 &);
+    template std::vector<std::vector<int>> seed_population(const tsplib_problem_t &, const candidate_lists_t &, int, const seeding_t &, std::mt19937 &);
+
+} // mhe
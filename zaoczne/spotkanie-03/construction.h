@@ -0,0 +1,82 @@
+#ifndef MHE_CONSTRUCTION_H
+#define MHE_CONSTRUCTION_H
+
+#include "problem_t.h"
+#include "vec2d.h"
+
+#include <random>
+#include <vector>
+
+namespace mhe {
+
+    /**
+     * Nearest neighbour tour: from the start city always go to the nearest city that
+     * was not visited yet, by problem.distance. Without the distance matrix the unvisited
+     * cities are kept in kd_tree_t, so it is about O(n log n) instead of O(n^2). With the
+     * matrix (any metric, also GEO and EXPLICIT) the candidate lists are checked first,
+     * and the row of the matrix only when all the candidates were visited.
+     */
+    template<class PROBLEM>
+    std::vector<int> nearest_neighbour_tour(const PROBLEM &problem, int start);
+
+    /**
+     * Nearest neighbour tour that with the probability noise goes to the second or
+     * the third nearest unvisited city instead of the nearest one (chosen uniformly).
+     */
+    template<class PROBLEM>
+    std::vector<int> randomized_nearest_neighbour_tour(const PROBLEM &problem, int start, double noise,
+                                                       std::mt19937 &rgen);
+
+    /**
+     * The cities sorted along the Hilbert curve over their bounding box, O(n log n).
+     * The curve is laid over the cities rotated by angle (radians), so different angles
+     * give different tours.
+     */
+    std::vector<int> hilbert_curve_tour(const std::vector<vec2d> &cities, double angle = 0.0);
+
+    /**
+     * Greedy edge matching: the candidate edges are added from the shortest one by
+     * problem.distance, unless a city would get the third edge or the edge would close
+     * a cycle (union-find). The fragments that are left are joined from the nearest free
+     * end, found as in nearest_neighbour_tour.
+     */
+    template<class PROBLEM>
+    std::vector<int> greedy_edge_tour(const PROBLEM &problem, const candidate_lists_t &candidates);
+
+    /// greedy_edge_tour with every edge length multiplied by a random factor from [1, 1 + noise)
+    template<class PROBLEM>
+    std::vector<int> greedy_edge_tour(const PROBLEM &problem, const candidate_lists_t &candidates,
+                                      double noise, std::mt19937 &rgen);
+
+    /// how seed_population builds the individuals
+    struct seeding_t {
+        double hilbert = 0.0; ///< part of the population from the Hilbert curve at random angles
+        double greedy = 0.0; ///< part from greedy_edge_tour with noise
+        double nearest_neighbour = 0.0; ///< part from randomized_nearest_neighbour_tour from random cities
+        double noise = 0.1; ///< the noise of greedy edge and nearest neighbour tours
+        // the rest of the population are random permutations
+    };
+
+    /**
+     * Initial population mixed from the construction heuristics. Every individual has its
+     * own random generator seeded from rgen, so they are built in parallel (OpenMP), and
+     * the result does not depend on the number of threads.
+     */
+    template<class PROBLEM>
+    std::vector<std::vector<int>> seed_population(const PROBLEM &problem, const candidate_lists_t &candidates,
+                                                  int count, const seeding_t &seeding, std::mt19937 &rgen);
+
+    extern template std::vector<int> nearest_neighbour_tour(const problem_t &, int);
+    extern template std::vector<int> nearest_neighbour_tour(const tsplib_problem_t &, int);
+    extern template std::vector<int> randomized_nearest_neighbour_tour(const problem_t &, int, double, std::mt19937 &);
+    extern template std::vector<int> randomized_nearest_neighbour_tour(const tsplib_problem_t &, int, double, std::mt19937 &);
+    extern template std::vector<int> greedy_edge_tour(const problem_t &, const candidate_lists_t &);
+    extern template std::vector<int> greedy_edge_tour(const tsplib_problem_t &, const candidate_lists_t &);
+    extern template std::vector<int> greedy_edge_tour(const problem_t &, const candidate_lists_t &, double, std::mt19937 &);
+    extern template std::vector<int> greedy_edge_tour(const tsplib_problem_t &, const candidate_lists_t &, double, std::mt19937 &);
+    extern template std::vector<std::vector<int>> seed_population(const problem_t &, const candidate_lists_t &, int, const seeding_t &, std::mt19937 &);
+    extern template std::vector<std::vector<int>> seed_population(const tsplib_problem_t &, const candidate_lists_t &, int, const seeding_t &, std::mt19937 &);
+
+} // mhe
+
+#endif //MHE_CONSTRUCTION_H
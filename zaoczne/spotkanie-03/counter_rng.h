@@ -0,0 +1,86 @@
+#ifndef MHE_COUNTER_RNG_H
+#define MHE_COUNTER_RNG_H
+
+#include <array>
+#include <cstdint>
+#include <limits>
+
+namespace mhe {
+
+    /// individuals in one parallel chunk of the genetic algorithms, even so the crossover pairs stay together
+    constexpr int generation_chunk = 32;
+
+    /// the operators that draw random numbers in a generation, a part of the counter of counter_rng_t
+    enum class random_operator_t : std::uint32_t {
+        selection = 1,
+        crossover = 2,
+        mutation = 3
+    };
+
+    /**
+     * Philox4x32-10, the counter-based generator of Salmon et al. (Random123): ten rounds
+     * of multiplications and xors scramble the 128-bit counter with the 64-bit key. The
+     * counter is (draw, individual, generation, operator) and the key is the seed, so
+     * every number is a pure function of where it is drawn, and the generators cost
+     * nothing to create. The genetic algorithms create one for every individual and
+     * operator, and give the same result for any number of threads.
+     *
+     * It is a UniformRandomBitGenerator, so it works with the std distributions.
+     */
+    class counter_rng_t {
+    public:
+        using result_type = std::uint32_t;
+        using block_t = std::array<std::uint32_t, 4>;
+
+        counter_rng_t(std::uint64_t seed, std::uint32_t generation, std::uint32_t individual, random_operator_t op) :
+                key{std::uint32_t(seed), std::uint32_t(seed >> 32)},
+                counter{0, individual, generation, std::uint32_t(op)} {}
+
+        static constexpr result_type min() { return 0; }
+        static constexpr result_type max() { return std::numeric_limits<result_type>::max(); }
+
+        result_type operator()() {
+            if (used == 4) {
+                block = philox(counter, key);
+                counter[0]++;
+                used = 0;
+            }
+            return block[used++];
+        }
+
+        /// the ten rounds on one counter
+        static block_t philox(block_t c, std::array<std::uint32_t, 2> k) {
+            for (int round = 0; round < 10; round++) {
+                const std::uint64_t p0 = std::uint64_t(0xD2511F53) * c[0];
+                const std::uint64_t p1 = std::uint64_t(0xCD9E8D57) * c[2];
+                c = {std::uint32_t(p1 >> 32) ^ c[1] ^ k[0], std::uint32_t(p1),
+                     std::uint32_t(p0 >> 32) ^ c[3] ^ k[1], std::uint32_t(p0)};
+                k[0] += 0x9E3779B9;
+                k[1] += 0xBB67AE85;
+            }
+            return c;
+        }
+
+    private:
+        std::array<std::uint32_t, 2> key;
+        block_t counter;
+        block_t block{};
+        int used = 4;
+    };
+
+    /// the seed and the generation of the random draws in one generation
+    struct generation_keys_t {
+        std::uint64_t seed = 0;
+        std::uint32_t generation = 0;
+        std::uint32_t first = 0; ///< the index of the individual 0 of the chunk
+
+        /// the generator of the operator on the individual first + i
+        counter_rng_t rng(int i, random_operator_t op) const { return {seed, generation, first + i, op}; }
+
+        /// the keys of the chunk that starts at the individual first + offset
+        generation_keys_t chunk(int offset) const { return {seed, generation, first + std::uint32_t(offset)}; }
+    };
+
+} // mhe
+
+#endif //MHE_COUNTER_RNG_H
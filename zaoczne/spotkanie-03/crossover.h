@@ -0,0 +1,183 @@
+#ifndef MHE_CROSSOVER_H
+#define MHE_CROSSOVER_H
+
+#include <cstdint>
+#include <random>
+#include <vector>
+
+namespace mhe {
+
+    /**
+     * The scratch arrays of the permutation crossovers, indexed by the cities and the
+     * positions. Between the calls they are -1 and 0, every operator clears only the
+     * entries it has set, so after the first call with the largest tour nothing is
+     * allocated. thread_crossover_workspace() is the one of the calling thread.
+     */
+    struct crossover_workspace_t {
+        std::vector<int> position[2]; ///< of the cities in the parents, -1 if not set
+        std::vector<char> city_mark;
+        std::vector<char> position_mark;
+
+        void reserve(int n) {
+            if (city_mark.size() >= std::size_t(n)) return;
+            for (auto &p: position) p.resize(n, -1);
+            city_mark.resize(n, 0);
+            position_mark.resize(n, 0);
+        }
+    };
+
+    inline crossover_workspace_t &thread_crossover_workspace() {
+        thread_local crossover_workspace_t workspace;
+        return workspace;
+    }
+
+    /*
+     * The operators below write the children of the permutations a and b of the cities
+     * 0 .. n - 1 into child_a and child_b, which have n elements and are not the parents.
+     * They are O(n). The tours are the solutions or the population_arena_t rows, they are
+     * accessed by the iterators, so the cached goals of the children are dropped once.
+     */
+
+    /**
+     * PMX: the children get the cities of the other parent between the cuts, and the
+     * cities of their own parent outside, mapped through the exchanged part while they
+     * repeat.
+     */
+    template<class PARENT, class CHILD>
+    void partially_mapped_crossover(const PARENT &a, const PARENT &b, int cut_begin, int cut_end,
+                                    CHILD &child_a, CHILD &child_b, crossover_workspace_t &workspace) {
+        const int n = a.size();
+        workspace.reserve(n);
+        auto pa = a.begin(), pb = b.begin();
+        auto ca = child_a.begin(), cb = child_b.begin();
+        auto &in_b = workspace.position[0];
+        auto &in_a = workspace.position[1];
+        for (int i = cut_begin; i < cut_end; i++) {
+            in_b[pb[i]] = i;
+            in_a[pa[i]] = i;
+        }
+        for (int i = 0; i < n; i++) {
+            if ((i >= cut_begin) && (i < cut_end)) {
+                ca[i] = pb[i];
+                cb[i] = pa[i];
+                continue;
+            }
+            // the chains of the different positions are disjoint, so it is O(n) in total
+            int city = pa[i];
+            while (in_b[city] >= 0) city = pa[in_b[city]];
+            ca[i] = city;
+            city = pb[i];
+            while (in_a[city] >= 0) city = pb[in_a[city]];
+            cb[i] = city;
+        }
+        for (int i = cut_begin; i < cut_end; i++) {
+            in_b[pb[i]] = -1;
+            in_a[pa[i]] = -1;
+        }
+    }
+
+    /**
+     * OX: the children keep the cities of their own parent between the cuts, the other
+     * positions from cut_end on get the remaining cities in the order of the other parent,
+     * also starting from cut_end.
+     */
+    template<class PARENT, class CHILD>
+    void order_crossover(const PARENT &a, const PARENT &b, int cut_begin, int cut_end,
+                         CHILD &child_a, CHILD &child_b, crossover_workspace_t &workspace) {
+        const int n = a.size();
+        workspace.reserve(n);
+        auto &kept = workspace.city_mark;
+        auto fill = [&](auto own, auto other, auto child) {
+            for (int i = cut_begin; i < cut_end; i++) {
+                child[i] = own[i];
+                kept[own[i]] = 1;
+            }
+            int k = cut_end % n;
+            for (int j = k, t = 0; t < n; t++, j = (j + 1 == n) ? 0 : j + 1) {
+                if (kept[other[j]]) continue;
+                child[k] = other[j];
+                k = (k + 1 == n) ? 0 : k + 1;
+            }
+            for (int i = cut_begin; i < cut_end; i++) kept[own[i]] = 0;
+        };
+        fill(a.begin(), b.begin(), child_a.begin());
+        fill(b.begin(), a.begin(), child_b.begin());
+    }
+
+    /**
+     * CX: the positions are split into the cycles of the parents, child_a takes the odd
+     * cycles from a and the even ones from b, child_b the other way round. No random choices.
+     */
+    template<class PARENT, class CHILD>
+    void cycle_crossover(const PARENT &a, const PARENT &b, CHILD &child_a, CHILD &child_b,
+                         crossover_workspace_t &workspace) {
+        const int n = a.size();
+        workspace.reserve(n);
+        auto pa = a.begin(), pb = b.begin();
+        auto ca = child_a.begin(), cb = child_b.begin();
+        auto &in_a = workspace.position[0];
+        auto &visited = workspace.position_mark;
+        for (int i = 0; i < n; i++) in_a[pa[i]] = i;
+        for (int start = 0, cycle = 0; start < n; start++) {
+            if (visited[start]) continue;
+            const bool own = (cycle++ % 2) == 0;
+            int i = start;
+            do {
+                visited[i] = 1;
+                ca[i] = own ? pa[i] : pb[i];
+                cb[i] = own ? pb[i] : pa[i];
+                i = in_a[pb[i]];
+            } while (i != start);
+        }
+        for (int i = 0; i < n; i++) {
+            in_a[pa[i]] = -1;
+            visited[i] = 0;
+        }
+    }
+
+    /**
+     * Position based crossover (Syswerda): every position is drawn with the probability
+     * 1/2, there the children keep their own parent, and the other positions get the
+     * remaining cities in the order of the other parent.
+     */
+    template<class PARENT, class CHILD, class RGEN>
+    void position_based_crossover(const PARENT &a, const PARENT &b, CHILD &child_a, CHILD &child_b,
+                                  RGEN &rgen, crossover_workspace_t &workspace) {
+        const int n = a.size();
+        workspace.reserve(n);
+        auto pa = a.begin(), pb = b.begin();
+        auto ca = child_a.begin(), cb = child_b.begin();
+        auto &kept = workspace.city_mark; // 1 if kept in child_a, 2 in child_b
+        auto &selected = workspace.position_mark;
+        std::uniform_int_distribution<std::uint32_t> word;
+        std::uint32_t bits = 0;
+        for (int i = 0; i < n; i++) {
+            if (i % 32 == 0) bits = word(rgen);
+            if (!((bits >> (i % 32)) & 1)) continue;
+            selected[i] = 1;
+            ca[i] = pa[i];
+            cb[i] = pb[i];
+            kept[pa[i]] |= 1;
+            kept[pb[i]] |= 2;
+        }
+        for (int j = 0, k = 0; j < n; j++) {
+            if (kept[pb[j]] & 1) continue;
+            while (selected[k]) k++;
+            ca[k++] = pb[j];
+        }
+        for (int j = 0, k = 0; j < n; j++) {
+            if (kept[pa[j]] & 2) continue;
+            while (selected[k]) k++;
+            cb[k++] = pa[j];
+        }
+        for (int i = 0; i < n; i++) {
+            if (!selected[i]) continue;
+            selected[i] = 0;
+            kept[pa[i]] = 0;
+            kept[pb[i]] = 0;
+        }
+    }
+
+} // mhe
+
+#endif //MHE_CROSSOVER_H
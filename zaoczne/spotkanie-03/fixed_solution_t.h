@@ -0,0 +1,131 @@
+#ifndef MHE_FIXED_SOLUTION_T_H
+#define MHE_FIXED_SOLUTION_T_H
+
+#include "problem_t.h"
+
+#include <algorithm>
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <random>
+#include <utility>
+
+namespace mhe {
+
+    /// calls f(std::integral_constant<std::size_t, I>{}) for I = 0..N-1, unrolled at compile time
+    template<std::size_t N, class F>
+    inline void static_for(F &&f) {
+        [&]<std::size_t... I>(std::index_sequence<I...>) {
+            (f(std::integral_constant<std::size_t, I>{}), ...);
+        }(std::make_index_sequence<N>{});
+    }
+
+    /// the distance matrix of a problem with N cities, N known at compile time
+    template<std::size_t N>
+    struct fixed_problem_t {
+        std::array<double, N * N> distances;
+
+        explicit fixed_problem_t(const problem_t &p) {
+            for (std::size_t a = 0; a < N; a++)
+                for (std::size_t b = 0; b < N; b++)
+                    distances[a * N + b] = p.distance(a, b);
+        }
+
+        double operator()(int a, int b) const { return distances[a * N + b]; }
+    };
+
+    /**
+     * Tour of exactly N cities in a std::array. All the loops over the tour are
+     * unrolled at compile time, and there is no heap allocation at all.
+     * The operators are the same as in solution_t and tsp_config_t.
+     */
+    template<std::size_t N>
+    struct fixed_solution_t : public std::array<std::uint8_t, N> {
+        static_assert(N >= 3 && N <= 256, "the fixed size tour is for 3 to 256 cities");
+
+        double goal(const fixed_problem_t<N> &p) const {
+            auto &t = *this;
+            double sum_distance = 0;
+            static_for<N>([&](auto i) { sum_distance += p(t[i], t[(i + 1) % N]); });
+            return sum_distance;
+        }
+
+        static fixed_solution_t random_solution(std::mt19937 &rgen) {
+            fixed_solution_t solution;
+            static_for<N>([&](auto i) { solution[i] = i; });
+            std::shuffle(solution.begin(), solution.end(), rgen);
+            return solution;
+        }
+
+        /// the same adjacent swap as swap_move
+        double swap_delta(const fixed_problem_t<N> &p, int i) const {
+            auto &t = *this;
+            int a = t[(i + N - 1) % N];
+            int b = t[i];
+            int c = t[(i + 1) % N];
+            int d = t[(i + 2) % N];
+            return p(a, c) + p(b, d) - p(a, b) - p(c, d);
+        }
+
+        /// the same random swap as swap_move::random
+        template<class RGEN>
+        void random_modify(RGEN &rgen) {
+            std::uniform_int_distribution<int> distr(0, N - 1);
+            int a = distr(rgen);
+            std::swap((*this)[a], (*this)[(a + 1) % N]);
+        }
+
+        std::array<fixed_solution_t, N> generate_neighbours() const {
+            std::array<fixed_solution_t, N> result;
+            static_for<N>([&](auto i) {
+                result[i] = *this;
+                std::swap(result[i][i], result[i][(i + 1) % N]);
+            });
+            return result;
+        }
+
+        fixed_solution_t best_neighbour(const fixed_problem_t<N> &p) const {
+            int best = 0;
+            double best_delta = swap_delta(p, 0);
+            static_for<N>([&](auto i) {
+                double delta = swap_delta(p, i);
+                if (delta < best_delta) {
+                    best_delta = delta;
+                    best = i;
+                }
+            });
+            fixed_solution_t result = *this;
+            std::swap(result[best], result[(best + 1) % N]);
+            return result;
+        }
+
+        /**
+         * PMX crossover with the segment [cut0, cut1). The mapping of the swapped
+         * cities is kept in flat arrays instead of maps.
+         */
+        static std::pair<fixed_solution_t, fixed_solution_t>
+        pmx(const fixed_solution_t &a, const fixed_solution_t &b, int cut0, int cut1) {
+            std::array<fixed_solution_t, 2> offspring = {a, b};
+            std::array<std::array<std::int16_t, N>, 2> taken_cities;
+            taken_cities[0].fill(-1);
+            taken_cities[1].fill(-1);
+            for (int i = cut0; i < cut1; i++) {
+                std::swap(offspring[0][i], offspring[1][i]);
+                taken_cities[0][offspring[0][i]] = offspring[1][i];
+                taken_cities[1][offspring[1][i]] = offspring[0][i];
+            }
+            static_for<2>([&](auto v) {
+                static_for<N>([&](auto i) {
+                    const int position = i;
+                    if ((position >= cut0) && (position < cut1)) return;
+                    while (taken_cities[v][offspring[v][i]] >= 0)
+                        offspring[v][i] = taken_cities[v][offspring[v][i]];
+                });
+            });
+            return {offspring[0], offspring[1]};
+        }
+    };
+
+} // mhe
+
+#endif //MHE_FIXED_SOLUTION_T_H
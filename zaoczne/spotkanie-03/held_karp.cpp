@@ -0,0 +1,83 @@
+#include "held_karp.h"
+
+#include <algorithm>
+#include <bit>
+#include <cstdint>
+#include <limits>
+#include <memory>
+#include <numeric>
+#include <stdexcept>
+#include <string>
+
+namespace mhe {
+
+    std::size_t held_karp_memory(int n, std::size_t cost_size) {
+        if (n < 2) return 0;
+        return std::size_t(n - 1) * (std::size_t(1) << (n - 1)) * cost_size;
+    }
+
+    template<class PROBLEM>
+    std::vector<int> held_karp_tour(const PROBLEM &problem, std::size_t memory_limit) {
+        using cost_t = held_karp_cost_t<PROBLEM>;
+        const int n = problem.size();
+        std::vector<int> tour(n);
+        std::iota(tour.begin(), tour.end(), 0);
+        if (n <= 3) return tour;
+        if ((n > 40) || (held_karp_memory(n, sizeof(cost_t)) > memory_limit))
+            throw std::invalid_argument("the Held-Karp table for " + std::to_string(n) + " cities does not fit in memory");
+
+        // the cities 1 .. n - 1 are the bits 0 .. m - 1 of the subsets
+        const int m = n - 1;
+        const std::uint32_t full = (std::uint32_t(1) << m) - 1;
+        std::vector<cost_t> distance(m * m);
+        for (int i = 0; i < m; i++)
+            for (int j = 0; j < m; j++) distance[i * m + j] = problem.distance(i + 1, j + 1);
+        // not initialized: only cost[S][j] for j in S is written and read
+        std::unique_ptr<cost_t[]> cost(new cost_t[std::size_t(full + 1) * m]);
+        auto at = [&](std::uint32_t subset, int j) -> cost_t & { return cost[std::size_t(subset) * m + j]; };
+
+        for (int j = 0; j < m; j++) at(std::uint32_t(1) << j, j) = problem.distance(0, j + 1);
+        for (int size = 2; size <= m; size++) {
+#pragma omp parallel for schedule(static, 1024)
+            for (std::int64_t s = 1; s <= full; s++) {
+                const auto subset = (std::uint32_t) s;
+                if (std::popcount(subset) != size) continue;
+                for (std::uint32_t js = subset; js; js &= js - 1) {
+                    const int j = std::countr_zero(js);
+                    const std::uint32_t before = subset ^ (std::uint32_t(1) << j);
+                    cost_t best = std::numeric_limits<cost_t>::max();
+                    for (std::uint32_t is = before; is; is &= is - 1) {
+                        const int i = std::countr_zero(is);
+                        best = std::min(best, cost_t(at(before, i) + distance[i * m + j]));
+                    }
+                    at(subset, j) = best;
+                }
+            }
+        }
+
+        // the path is read back: the predecessor is the city that gives the stored cost
+        auto closing = [&](int j) { return cost_t(at(full, j) + problem.distance(j + 1, 0)); };
+        int last = 0;
+        for (int j = 1; j < m; j++)
+            if (closing(j) < closing(last)) last = j;
+        std::uint32_t subset = full;
+        for (int k = n - 1; k >= 1; k--) {
+            tour[k] = last + 1;
+            const std::uint32_t before = subset ^ (std::uint32_t(1) << last);
+            int previous = -1;
+            for (std::uint32_t is = before; is; is &= is - 1) {
+                const int i = std::countr_zero(is);
+                if ((previous < 0) || (at(before, i) + distance[i * m + last] < at(before, previous) + distance[previous * m + last]))
+                    previous = i;
+            }
+            subset = before;
+            last = previous;
+        }
+        tour[0] = 0;
+        return tour;
+    }
+
+    template std::vector<int> held_karp_tour(const problem_t &, std::size_t);
+    template std::vector<int> held_karp_tour(const tsplib_problem_t &, std::size_t);
+
+} // mhe
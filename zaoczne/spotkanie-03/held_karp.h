@@ -0,0 +1,45 @@
+#ifndef MHE_HELD_KARP_H
+#define MHE_HELD_KARP_H
+
+#include "problem_t.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <type_traits>
+#include <vector>
+
+namespace mhe {
+
+    /// the memory of the Held-Karp table above which held_karp_tour refuses to run
+    constexpr std::size_t default_held_karp_memory_limit = std::size_t(2) * 1024 * 1024 * 1024;
+
+    /// the costs of the Held-Karp table: exact int32 for the integer metrics, double otherwise
+    template<class PROBLEM>
+    using held_karp_cost_t = std::conditional_t<std::is_integral_v<typename PROBLEM::distance_type>, std::int32_t, double>;
+
+    /**
+     * The memory used by held_karp_tour for n cities: one cost of cost_size bytes for every
+     * subset of the cities other than 0 and every last city, (n - 1) * 2^(n - 1) * cost_size.
+     * Within the default limit it is up to 25 cities with int32 and 24 with double.
+     */
+    std::size_t held_karp_memory(int n, std::size_t cost_size);
+
+    /**
+     * The optimal tour by the Held-Karp dynamic programming, O(n^2 2^n). The tour starts
+     * in city 0, and cost[S][j] is the shortest path from 0 through the subset S that ends
+     * in j. The subsets are bit masks, and all the subsets of the same size are computed
+     * in parallel (OpenMP), because they depend only on the smaller ones. The costs are
+     * held_karp_cost_t, as precise as the metric, and the path is read back from the table
+     * instead of keeping the predecessors.
+     *
+     * Throws std::invalid_argument if the table would take more than memory_limit bytes.
+     */
+    template<class PROBLEM>
+    std::vector<int> held_karp_tour(const PROBLEM &problem, std::size_t memory_limit = default_held_karp_memory_limit);
+
+    extern template std::vector<int> held_karp_tour(const problem_t &, std::size_t);
+    extern template std::vector<int> held_karp_tour(const tsplib_problem_t &, std::size_t);
+
+} // mhe
+
+#endif //MHE_HELD_KARP_H
@@ -0,0 +1,141 @@
+#include "kd_tree.h"
+
+#include <algorithm>
+
+namespace mhe {
+
+    kd_tree_t::kd_tree_t(const std::vector<vec2d> &cities) :
+            order(cities.size()), points(cities.size()), slot(cities.size()), leaf(cities.size()) {
+        if (cities.empty()) return;
+        for (int i = 0; i < order.size(); i++) order[i] = i;
+        // the coordinates are needed by build, then they are kept in the tree order
+        for (int i = 0; i < points.size(); i++) points[i] = cities[i];
+        nodes.reserve(2 * cities.size() / leaf_size + 1);
+        build(0, cities.size(), -1);
+        for (int i = 0; i < order.size(); i++) {
+            points[i] = cities[order[i]];
+            slot[order[i]] = i;
+        }
+    }
+
+    int kd_tree_t::build(int begin, int end, int parent) {
+        int index = nodes.size();
+        nodes.push_back({});
+        node_t node{};
+        node.low = {std::numeric_limits<double>::max(), std::numeric_limits<double>::max()};
+        node.high = {std::numeric_limits<double>::lowest(), std::numeric_limits<double>::lowest()};
+        for (int i = begin; i < end; i++) {
+            auto &c = points[order[i]];
+            for (int d = 0; d < 2; d++) {
+                node.low[d] = std::min(node.low[d], c[d]);
+                node.high[d] = std::max(node.high[d], c[d]);
+            }
+        }
+        node.begin = begin;
+        node.end = end;
+        node.alive = end - begin;
+        node.left = node.right = -1;
+        node.parent = parent;
+        if (end - begin > leaf_size) {
+            // split at the median of the wider side of the box
+            int d = (node.high[0] - node.low[0] >= node.high[1] - node.low[1]) ? 0 : 1;
+            int middle = begin + (end - begin) / 2;
+            std::nth_element(order.begin() + begin, order.begin() + middle, order.begin() + end,
+                             [&](int a, int b) { return points[a][d] < points[b][d]; });
+            node.left = build(begin, middle, index);
+            node.right = build(middle, end, index);
+        } else {
+            for (int i = begin; i < end; i++) leaf[order[i]] = index;
+        }
+        nodes[index] = node;
+        return index;
+    }
+
+    double kd_tree_t::box_distance2(const node_t &node, vec2d p) const {
+        double sum = 0;
+        for (int d = 0; d < 2; d++) {
+            double outside = std::max({node.low[d] - p[d], 0.0, p[d] - node.high[d]});
+            sum += outside * outside;
+        }
+        return sum;
+    }
+
+    template<class FOUND>
+    void kd_tree_t::search(int index, double distance2, vec2d p, int skip, FOUND &found) const {
+        auto &node = nodes[index];
+        if ((node.alive == 0) || (distance2 > found.bound())) return;
+        if (node.left < 0) {
+            for (int i = node.begin; i < node.begin + node.alive; i++) {
+                if (order[i] == skip) continue;
+                auto v = points[i] - p;
+                found.add(v[0] * v[0] + v[1] * v[1], order[i]);
+            }
+            return;
+        }
+        int first = node.left;
+        int second = node.right;
+        double first_distance2 = box_distance2(nodes[first], p);
+        double second_distance2 = box_distance2(nodes[second], p);
+        if (second_distance2 < first_distance2) {
+            std::swap(first, second);
+            std::swap(first_distance2, second_distance2);
+        }
+        search(first, first_distance2, p, skip, found);
+        search(second, second_distance2, p, skip, found);
+    }
+
+    namespace {
+        /// the nearest city, the ties go to the lower city number
+        struct nearest_found_t {
+            std::pair<double, int> best = {std::numeric_limits<double>::max(), -1};
+
+            double bound() const { return best.first; }
+
+            void add(double d2, int city) { best = std::min(best, {d2, city}); }
+        };
+
+        /// the k nearest cities, sorted by the distance and the city number
+        struct k_nearest_found_t {
+            int k;
+            std::vector<std::pair<double, int>> best;
+
+            double bound() const { return (best.size() < k) ? std::numeric_limits<double>::max() : best.back().first; }
+
+            void add(double d2, int city) {
+                std::pair<double, int> candidate = {d2, city};
+                if ((best.size() == k) && !(candidate < best.back())) return;
+                if (best.size() == k) best.pop_back();
+                best.insert(std::upper_bound(best.begin(), best.end(), candidate), candidate);
+            }
+        };
+    }
+
+    int kd_tree_t::nearest(vec2d p) const {
+        nearest_found_t found;
+        if (!nodes.empty()) search(0, box_distance2(nodes[0], p), p, -1, found);
+        return found.best.second;
+    }
+
+    void kd_tree_t::k_nearest(vec2d p, int k, int skip, std::vector<int> &result) const {
+        k_nearest_found_t found{k, {}};
+        found.best.reserve(k + 1);
+        if (!nodes.empty() && (k > 0)) search(0, box_distance2(nodes[0], p), p, skip, found);
+        result.clear();
+        for (auto &e: found.best) result.push_back(e.second);
+    }
+
+    void kd_tree_t::remove(int city) {
+        int index = leaf[city];
+        auto &node = nodes[index];
+        int i = slot[city];
+        if (i >= node.begin + node.alive) return;
+        // the removed city goes behind the cities that are left in the leaf
+        int last = node.begin + node.alive - 1;
+        std::swap(order[i], order[last]);
+        std::swap(points[i], points[last]);
+        slot[order[i]] = i;
+        slot[order[last]] = last;
+        for (; index >= 0; index = nodes[index].parent) nodes[index].alive--;
+    }
+
+} // mhe
@@ -0,0 +1,67 @@
+#ifndef MHE_KD_TREE_H
+#define MHE_KD_TREE_H
+
+#include "vec2d.h"
+
+#include <limits>
+#include <utility>
+#include <vector>
+
+namespace mhe {
+
+    /**
+     * 2-d tree over the cities for the nearest neighbour queries. Cities can be removed
+     * from the tree, and the subtrees without any city left are skipped, so "the nearest
+     * unvisited city" is a query instead of a scan. Building is O(n log n), a query
+     * is about O(log n).
+     */
+    class kd_tree_t {
+    public:
+        explicit kd_tree_t(const std::vector<vec2d> &cities);
+
+        /// the nearest city to p that is still in the tree, or -1 if the tree is empty
+        int nearest(vec2d p) const;
+
+        /// up to k cities nearest to p, except the city skip, sorted by the distance
+        void k_nearest(vec2d p, int k, int skip, std::vector<int> &result) const;
+
+        void remove(int city);
+
+        /// the number of cities left in the tree
+        int size() const { return nodes.empty() ? 0 : nodes[0].alive; }
+
+        /// the cities in the order of the leaves; the neighbours in space are close in this order
+        const std::vector<int> &spatial_order() const { return order; }
+
+    private:
+        static constexpr int leaf_size = 8;
+
+        struct node_t {
+            vec2d low; ///< bounding box of the subtree
+            vec2d high;
+            int begin; ///< the cities of the subtree are at [begin, begin + alive) in order
+            int end;
+            int alive;
+            int left; ///< children, -1 in leaves
+            int right;
+            int parent;
+        };
+
+        std::vector<node_t> nodes;
+        std::vector<int> order; ///< the cities in the tree order
+        std::vector<vec2d> points; ///< the coordinates in the tree order
+        std::vector<int> slot; ///< position of every city in order
+        std::vector<int> leaf; ///< the leaf of every city
+
+        int build(int begin, int end, int parent);
+
+        /// the squared distance from p to the bounding box of the node
+        double box_distance2(const node_t &node, vec2d p) const;
+
+        template<class FOUND>
+        void search(int node, double distance2, vec2d p, int skip, FOUND &found) const;
+    };
+
+} // mhe
+
+#endif //MHE_KD_TREE_H
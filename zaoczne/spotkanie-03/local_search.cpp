@@ -0,0 +1,263 @@
+#include "local_search.h"
+#include "moves.h"
+#include "two_level_tour.h"
+
+#include <algorithm>
+#include <array>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <tuple>
+#include <vector>
+
+namespace mhe {
+
+    namespace {
+        const double improvement_eps = 1e-10;
+
+        /// the moves tried from every active city
+        struct moves_t {
+            bool two_opt = false;
+            bool or_opt = false;
+            int lin_kernighan_depth = 0; ///< 0 - no Lin-Kernighan step
+        };
+
+        /**
+         * 2-opt, Or-opt and Lin-Kernighan with candidate lists and don't-look bits. The moves
+         * are expressed by next/prev/flip, so TOUR can be array_tour_t or two_level_tour_t.
+         */
+        template<class PROBLEM, class TOUR>
+        class dont_look_bits_search {
+        public:
+            dont_look_bits_search(const PROBLEM &p_, TOUR &t_) : p(p_), t(t_), n(t_.size()) {
+                candidates = p.candidates ? p.candidates : p.nearest_candidates(default_candidates);
+                active.assign(n, true);
+                queue.resize(n);
+                t.copy_to(queue.begin());
+            }
+
+            double run(const moves_t &moves) {
+                double total = 0;
+                max_depth = moves.lin_kernighan_depth;
+                while (!queue.empty()) {
+                    int a = queue.front();
+                    queue.pop_front();
+                    active[a] = false;
+                    if (moves.two_opt) total += improve_two_opt(a);
+                    if (max_depth > 0) total += improve_lin_kernighan(a);
+                    if (moves.or_opt) total += improve_or_opt(a);
+                }
+                return total;
+            }
+
+        private:
+            const PROBLEM &p;
+            TOUR &t;
+            const int n;
+            std::shared_ptr<const candidate_lists_t> candidates;
+            std::vector<bool> active; ///< negation of the don't-look bit
+            std::deque<int> queue;
+
+            /// the Lin-Kernighan chain: the applied exchanges, and the edges it added and removed
+            int max_depth = 0;
+            std::vector<std::array<int, 4>> exchanges;
+            std::vector<std::pair<int, int>> added;
+            std::vector<std::pair<int, int>> removed;
+            double best_gain = 0;
+            int best_depth = 0;
+
+            void activate(int city) {
+                if (active[city]) return;
+                active[city] = true;
+                queue.push_back(city);
+            }
+
+            /// tries to replace the edge (a, succ(a)) or (pred(a), a) with the edge (a, c)
+            double improve_two_opt(int a) {
+                for (int dir = 0; dir < 2; dir++) {
+                    int b = (dir == 0) ? t.next(a) : t.prev(a);
+                    double d_ab = p.distance(a, b);
+                    for (auto it = candidates->begin(a); it != candidates->end(a); ++it) {
+                        int c = *it;
+                        double d_ac = p.distance(a, c);
+                        if (d_ac >= d_ab) break;
+                        int d = (dir == 0) ? t.next(c) : t.prev(c);
+                        if ((c == b) || (d == a)) continue;
+                        double delta = d_ac + p.distance(b, d) - d_ab - p.distance(c, d);
+                        if (delta < -improvement_eps) {
+                            exchange(t, a, b, c, d);
+                            for (int city: {a, b, c, d}) activate(city);
+                            return delta;
+                        }
+                    }
+                }
+                return 0.0;
+            }
+
+            static bool contains(const std::vector<std::pair<int, int>> &edges, int a, int b) {
+                for (auto [x, y]: edges)
+                    if (((x == a) && (y == b)) || ((x == b) && (y == a))) return true;
+                return false;
+            }
+
+            /**
+             * One level of the Lin-Kernighan chain. The tour has the edge (t1, t2), the chain
+             * removed edges of the total length gain more than it added, without (t1, t2).
+             * The edge (t2, t3) to a candidate is added and (t3, t4) is removed, so that
+             * closing with (t4, t1) gives a tour - it is one exchange. Then the search goes on
+             * from (t1, t4). The first two levels try a few t3 (backtracking), the deeper ones
+             * only the best. Every level closes a sequential k-opt move, so the chain covers
+             * 2-opt, 3-opt, 5-opt etc. up to max_depth + 1 exchanged edges.
+             */
+            void lin_kernighan_step(int t1, int t2, double gain, int level) {
+                const int breadth[] = {5, 3, 1};
+                std::array<std::tuple<double, int, int>, 16> steps;
+                int count = 0;
+                const bool forward = t.next(t1) == t2;
+                for (auto it = candidates->begin(t2); (it != candidates->end(t2)) && (count < steps.size()); ++it) {
+                    int t3 = *it;
+                    double g = gain - p.distance(t2, t3);
+                    if (g <= improvement_eps) break;
+                    if ((t3 == t.next(t2)) || (t3 == t.prev(t2))) continue;
+                    int t4 = forward ? t.prev(t3) : t.next(t3);
+                    if (contains(removed, t2, t3) || contains(added, t3, t4)) continue;
+                    steps[count++] = {g + p.distance(t3, t4), t3, t4};
+                }
+                // the longest removed edge first
+                std::sort(steps.begin(), steps.begin() + count, std::greater<>());
+                count = std::min(count, breadth[std::min(level, 2)]);
+                for (int k = 0; k < count; k++) {
+                    auto [g, t3, t4] = steps[k];
+                    double closed = g - p.distance(t4, t1);
+                    // at the last level only the improving exchange is worth applying
+                    if ((level + 1 >= max_depth) && (closed <= best_gain)) continue;
+                    exchange(t, t1, t2, t4, t3);
+                    exchanges.push_back({t1, t2, t4, t3});
+                    added.push_back({t2, t3});
+                    removed.push_back({t3, t4});
+                    if (closed > best_gain) {
+                        best_gain = closed;
+                        best_depth = exchanges.size();
+                    }
+                    if (level + 1 < max_depth) lin_kernighan_step(t1, t4, g, level + 1);
+                    if (best_gain > improvement_eps) return;
+                    undo_exchange();
+                }
+            }
+
+            void undo_exchange() {
+                auto [a, b, c, d] = exchanges.back();
+                exchange(t, a, c, b, d);
+                exchanges.pop_back();
+                added.pop_back();
+                removed.pop_back();
+            }
+
+            /// the Lin-Kernighan chain from the edges (a, succ(a)) and (pred(a), a)
+            double improve_lin_kernighan(int a) {
+                for (int b: {t.next(a), t.prev(a)}) {
+                    best_gain = 0;
+                    best_depth = 0;
+                    lin_kernighan_step(a, b, p.distance(a, b), 0);
+                    // the chain is kept up to the best closed tour
+                    while (exchanges.size() > best_depth) undo_exchange();
+                    if (best_gain <= improvement_eps) continue;
+                    for (auto &e: exchanges)
+                        for (int city: e) activate(city);
+                    exchanges.clear();
+                    added.clear();
+                    removed.clear();
+                    return -best_gain;
+                }
+                return 0.0;
+            }
+
+            /// tries to move the segment that starts with a next to one of its candidates
+            double improve_or_opt(int a) {
+                int last = a;
+                for (int len = 1; len <= std::min(or_opt_move::max_len, n - 3); len++) {
+                    if (len > 1) last = t.next(last);
+                    int prev = t.prev(a);
+                    int next = t.next(last);
+                    double removal_gain = p.distance(prev, a) + p.distance(last, next) - p.distance(prev, next);
+                    if (removal_gain <= improvement_eps) continue;
+                    auto in_segment = [&](int city) {
+                        for (int k = 0, s = a; k < len; k++, s = t.next(s))
+                            if (s == city) return true;
+                        return false;
+                    };
+                    for (auto it = candidates->begin(a); it != candidates->end(a); ++it) {
+                        int c = *it;
+                        double d_ac = p.distance(a, c);
+                        if (d_ac >= removal_gain) break;
+                        if (in_segment(c)) continue;
+                        // c - a ... last - succ(c)
+                        if (c != prev) {
+                            int e = t.next(c);
+                            double delta = d_ac + p.distance(last, e) - p.distance(c, e) - removal_gain;
+                            if (delta < -improvement_eps) {
+                                move_segment(t, a, last, c, e, false);
+                                for (int city: {a, last, prev, next, c, e}) activate(city);
+                                return delta;
+                            }
+                        }
+                        // pred(c) - last ... a - c
+                        if (c != next) {
+                            int c_left = t.prev(c);
+                            double delta = p.distance(c_left, last) + d_ac - p.distance(c_left, c) - removal_gain;
+                            if (delta < -improvement_eps) {
+                                move_segment(t, a, last, c_left, c, true);
+                                for (int city: {a, last, prev, next, c_left, c}) activate(city);
+                                return delta;
+                            }
+                        }
+                    }
+                }
+                return 0.0;
+            }
+        };
+
+        template<class TOUR, class SOLUTION>
+        double local_search_on(SOLUTION &s, const moves_t &moves) {
+            const SOLUTION &read_only = s;
+            TOUR tour(read_only.begin(), read_only.end());
+            dont_look_bits_search search(*s.problem, tour);
+            double change = search.run(moves);
+            if (change == 0.0) return change;
+            auto goal_before = s.cached_goal();
+            tour.copy_to(s.begin());
+            if (goal_before) s.set_cached_goal(*goal_before + change);
+            return change;
+        }
+
+        template<class SOLUTION>
+        double local_search_on(SOLUTION &s, const moves_t &moves) {
+            if (s.size() < 5) return 0.0;
+            if (s.size() >= two_level_tour_min_cities) return local_search_on<two_level_tour_t>(s, moves);
+            return local_search_on<array_tour_t>(s, moves);
+        }
+    }
+
+    template<class SOLUTION>
+    double local_search(SOLUTION &s, bool use_two_opt, bool use_or_opt) {
+        return local_search_on(s, {use_two_opt, use_or_opt, 0});
+    }
+
+    template<class SOLUTION>
+    double lin_kernighan(SOLUTION &s, int max_depth) {
+        return local_search_on(s, {false, true, max_depth});
+    }
+
+    template double local_search(solution_t &, bool, bool);
+    template double local_search(solution16_t &, bool, bool);
+    template double local_search(solution32_t &, bool, bool);
+    template double local_search(inline_solution_t &, bool, bool);
+    template double local_search(tsplib_solution_t &, bool, bool);
+
+    template double lin_kernighan(solution_t &, int);
+    template double lin_kernighan(solution16_t &, int);
+    template double lin_kernighan(solution32_t &, int);
+    template double lin_kernighan(inline_solution_t &, int);
+    template double lin_kernighan(tsplib_solution_t &, int);
+
+} // mhe
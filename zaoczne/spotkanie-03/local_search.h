@@ -0,0 +1,56 @@
+#ifndef MHE_LOCAL_SEARCH_H
+#define MHE_LOCAL_SEARCH_H
+
+#include "solution_t.h"
+
+namespace mhe {
+
+    /// candidate list length used when the problem has no precomputed lists
+    constexpr int default_candidates = 8;
+
+    /// the number of exchanges in one Lin-Kernighan move
+    constexpr int default_lin_kernighan_depth = 10;
+
+    /**
+     * Local search with 2-opt and/or Or-opt moves. Only the moves connecting a city
+     * with one of its nearest neighbours are checked (problem_t::candidates), and
+     * cities whose surrounding did not change recently are skipped (don't-look bits).
+     * One pass costs about O(n k) instead of O(n^2).
+     *
+     * The solution is improved in place until it is a local optimum.
+     * @return the change of goal()
+     */
+    template<class SOLUTION>
+    double local_search(SOLUTION &s, bool use_two_opt, bool use_or_opt);
+
+    template<class SOLUTION>
+    double two_opt_local_search(SOLUTION &s) { return local_search(s, true, false); }
+
+    template<class SOLUTION>
+    double or_opt_local_search(SOLUTION &s) { return local_search(s, false, true); }
+
+    /**
+     * Lin-Kernighan local search: from every active city a chain of exchanges is built
+     * while the partial gain stays positive, and the best closed tour along the chain is
+     * kept (sequential 2-, 3-, ..., (max_depth + 1)-opt). Or-opt moves are tried too.
+     * It uses the same candidate lists, don't-look bits and tours as local_search.
+     * @return the change of goal()
+     */
+    template<class SOLUTION>
+    double lin_kernighan(SOLUTION &s, int max_depth = default_lin_kernighan_depth);
+
+    extern template double local_search(solution_t &, bool, bool);
+    extern template double local_search(solution16_t &, bool, bool);
+    extern template double local_search(solution32_t &, bool, bool);
+    extern template double local_search(inline_solution_t &, bool, bool);
+    extern template double local_search(tsplib_solution_t &, bool, bool);
+
+    extern template double lin_kernighan(solution_t &, int);
+    extern template double lin_kernighan(solution16_t &, int);
+    extern template double lin_kernighan(solution32_t &, int);
+    extern template double lin_kernighan(inline_solution_t &, int);
+    extern template double lin_kernighan(tsplib_solution_t &, int);
+
+} // mhe
+
+#endif //MHE_LOCAL_SEARCH_H
@@ -0,0 +1,208 @@
+#include "lower_bound.h"
+#include "construction.h"
+#include "kd_tree.h"
+#include "local_search.h"
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <memory>
+#include <numeric>
+#include <type_traits>
+#include <vector>
+
+namespace mhe {
+
+    namespace {
+        const double infinity = std::numeric_limits<double>::infinity();
+
+        /// the minimum 1-tree with the penalties, degree gets the number of tree edges of every city
+        template<class PROBLEM>
+        double one_tree(const PROBLEM &p, const std::vector<double> &pi, std::vector<int> &degree) {
+            const int n = p.size();
+            auto weight = [&](int a, int b) { return p.distance(a, b) + pi[a] + pi[b]; };
+            std::vector<double> key(n, infinity);
+            std::vector<int> parent(n, -1);
+            std::vector<char> in_tree(n, false);
+            degree.assign(n, 0);
+            // Prim on the cities 1 .. n - 1; the keys are updated from the city added last.
+            // The threads are started once, every step ends with a barrier and one thread
+            // adds the chosen city.
+            double value = 0;
+            int added = 1;
+            int next = -1;
+            double next_key = infinity;
+            in_tree[0] = in_tree[1] = true;
+#pragma omp parallel
+            for (int step = 2; step < n; step++) {
+                int local = -1;
+                double local_key = infinity;
+#pragma omp for nowait
+                for (int u = 2; u < n; u++) {
+                    if (in_tree[u]) continue;
+                    double w = weight(added, u);
+                    if (w < key[u]) {
+                        key[u] = w;
+                        parent[u] = added;
+                    }
+                    if ((local < 0) || (key[u] < local_key)) {
+                        local = u;
+                        local_key = key[u];
+                    }
+                }
+#pragma omp critical
+                if ((local >= 0) && ((next < 0) || (local_key < next_key) || ((local_key == next_key) && (local < next)))) {
+                    next = local;
+                    next_key = local_key;
+                }
+#pragma omp barrier
+#pragma omp single
+                {
+                    in_tree[next] = true;
+                    value += next_key;
+                    degree[next]++;
+                    degree[parent[next]]++;
+                    added = next;
+                    next = -1;
+                    next_key = infinity;
+                }
+            }
+            // and the two cheapest edges of the city 0
+            int ends[2] = {-1, -1};
+            for (int u = 1; u < n; u++) {
+                if ((ends[1] < 0) || (weight(0, u) < weight(0, ends[1]))) {
+                    ends[1] = u;
+                    if ((ends[0] < 0) || (weight(0, ends[1]) < weight(0, ends[0]))) std::swap(ends[0], ends[1]);
+                }
+            }
+            for (int u: ends) {
+                value += weight(0, u);
+                degree[0]++;
+                degree[u]++;
+            }
+            return value - 2 * std::accumulate(pi.begin(), pi.end(), 0.0);
+        }
+
+        /**
+         * Every city takes its two cheapest edges, the tour has half of their sum at least.
+         * The cities are renumbered in the kd-tree order and the candidate edges are
+         * copied with their lengths, so the rounds go through memory almost in order.
+         */
+        class two_neighbours_t {
+        public:
+            template<class PROBLEM>
+            two_neighbours_t(const PROBLEM &p, const candidate_lists_t &candidates) :
+                    n(p.size()), k(candidates.k), neighbour(n * k), length(n * k), farthest(n) {
+                const kd_tree_t tree(p);
+                const auto &order = tree.spatial_order();
+                std::vector<int> rank(n);
+                for (int i = 0; i < n; i++) rank[order[i]] = i;
+#pragma omp parallel for schedule(static, 1024)
+                for (int i = 0; i < n; i++) {
+                    const int a = order[i];
+                    for (int j = 0; j < k; j++) {
+                        const int b = candidates.begin(a)[j];
+                        neighbour[i * k + j] = rank[b];
+                        length[i * k + j] = p.distance(a, b);
+                        farthest[i] = std::max(farthest[i], length[i * k + j]);
+                    }
+                }
+            }
+
+            /**
+             * degree gets the number of times every city was taken by the others. The city
+             * is in its own two edges too, so degree - 2 is twice the subgradient, as for
+             * the 1-tree.
+             */
+            double operator()(const std::vector<double> &pi, std::vector<int> &degree) const {
+                const int cheapest = std::min_element(pi.begin(), pi.end()) - pi.begin();
+                degree.assign(n, 0);
+                double sum = 0;
+#pragma omp parallel for reduction(+ : sum) schedule(static, 1024)
+                for (int a = 0; a < n; a++) {
+                    // the cities that are not candidates are at least as far as the farthest one
+                    double w[2] = {farthest[a] + pi[a] + pi[cheapest], farthest[a] + pi[a] + pi[cheapest]};
+                    int b[2] = {cheapest, cheapest};
+                    for (int j = a * k; j < (a + 1) * k; j++) {
+                        double candidate = length[j] + pi[a] + pi[neighbour[j]];
+                        if (candidate < w[1]) {
+                            w[1] = candidate;
+                            b[1] = neighbour[j];
+                            if (w[1] < w[0]) {
+                                std::swap(w[0], w[1]);
+                                std::swap(b[0], b[1]);
+                            }
+                        }
+                    }
+                    sum += w[0] + w[1];
+                    for (int c: b) {
+#pragma omp atomic
+                        degree[c]++;
+                    }
+                }
+                return sum / 2 - 2 * std::accumulate(pi.begin(), pi.end(), 0.0);
+            }
+
+        private:
+            const int n;
+            const int k;
+            std::vector<int> neighbour;
+            std::vector<double> length;
+            std::vector<double> farthest;
+        };
+    }
+
+    template<class PROBLEM>
+    double tour_lower_bound(const PROBLEM &problem, int rounds) {
+        const int n = problem.size();
+        auto tour_length = [&](const std::vector<int> &tour) {
+            double length = 0;
+            for (int i = 0; i < n; i++) length += problem.distance(tour[i], tour[(i + 1) % n]);
+            return length;
+        };
+        if (n <= 3) {
+            std::vector<int> tour(n);
+            std::iota(tour.begin(), tour.end(), 0);
+            return tour_length(tour);
+        }
+        std::unique_ptr<two_neighbours_t> two_neighbours;
+        if (n > one_tree_max_cities) {
+            auto candidates = problem.candidates ? problem.candidates : problem.nearest_candidates(default_candidates);
+            two_neighbours = std::make_unique<two_neighbours_t>(problem, *candidates);
+        }
+        auto relaxation = [&](const std::vector<double> &pi, std::vector<int> &degree) {
+            return two_neighbours ? (*two_neighbours)(pi, degree) : one_tree(problem, pi, degree);
+        };
+
+        // the subgradient steps are scaled by the gap to the nearest neighbour tour
+        const double upper = tour_length(nearest_neighbour_tour(problem, 0));
+        std::vector<double> pi(n, 0.0);
+        std::vector<int> degree;
+        double best = -infinity;
+        double lambda = 0.2;
+        const int period = std::max(5, rounds / 10);
+        for (int round = 0, stalled = 0; round < std::max(1, rounds); round++) {
+            double value = relaxation(pi, degree);
+            if (value > best) {
+                best = value;
+                stalled = 0;
+            } else if (++stalled >= period) {
+                lambda /= 2;
+                stalled = 0;
+            }
+            double norm = 0;
+            for (int d: degree) norm += (d - 2) * (d - 2);
+            if (norm == 0) break;
+            double step = lambda * std::max(upper - value, 0.0) / norm;
+            for (int i = 0; i < n; i++) pi[i] += step * (degree[i] - 2);
+        }
+        // the sums of the doubles may end a few ulps above the optimum, the bound stays below it
+        if (std::is_integral_v<typename PROBLEM::distance_type>) best = std::ceil(best - 1e-9);
+        else best -= std::abs(best) * 1e-12;
+        return std::min(best, upper);
+    }
+
+    template double tour_lower_bound(const problem_t &, int);
+    template double tour_lower_bound(const tsplib_problem_t &, int);
+
+} // mhe
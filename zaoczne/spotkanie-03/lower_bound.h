@@ -0,0 +1,57 @@
+#ifndef MHE_LOWER_BOUND_H
+#define MHE_LOWER_BOUND_H
+
+#include "problem_t.h"
+
+#include <algorithm>
+#include <chrono>
+
+namespace mhe {
+
+    /// up to this many cities tour_lower_bound computes the 1-trees on all the pairs of cities
+    constexpr int one_tree_max_cities = 3000;
+
+    /// the default number of subgradient rounds of tour_lower_bound
+    constexpr int default_lower_bound_rounds = 50;
+
+    /**
+     * A lower bound of the shortest tour, fast enough to be computed before the search.
+     * It is the Held-Karp bound: a relaxation of the tour with city penalties pi that are
+     * raised by subgradient steps on the cities with too many edges and lowered on the
+     * ones with too few. Any pi gives a valid bound, the best one of the rounds is returned.
+     *
+     * Up to one_tree_max_cities the relaxation is the minimum 1-tree (O(n^2) Prim, the
+     * inner loop is parallel). Above that every city takes its two cheapest edges to its
+     * nearest candidates, and an edge to any other city costs at least as much as the
+     * one to the farthest candidate, so it is O(n k) per round (OpenMP parallel). For the
+     * integer metrics the bound is rounded up, for the double ones it is lowered by 1e-12 of
+     * itself, so the rounding of the sums does not raise it above the optimum.
+     */
+    template<class PROBLEM>
+    double tour_lower_bound(const PROBLEM &problem, int rounds = default_lower_bound_rounds);
+
+    extern template double tour_lower_bound(const problem_t &, int);
+    extern template double tour_lower_bound(const tsplib_problem_t &, int);
+
+    /// (length - lower_bound) / lower_bound, 0.01 is 1% above the bound, never below 0
+    inline double optimality_gap(double length, double lower_bound) {
+        return (lower_bound > 0) ? std::max(length - lower_bound, 0.0) / lower_bound : 0.0;
+    }
+
+    /// when the iterative solvers stop besides their iteration counts, 0 disables a limit
+    struct stop_condition_t {
+        double time_limit = 0.0; ///< seconds from start
+        double lower_bound = 0.0; ///< from tour_lower_bound
+        double gap = 0.0; ///< stop when the best tour is within that gap of lower_bound, 0.01 is 1%
+        std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+
+        bool reached(double best_length) const {
+            if ((lower_bound > 0) && (optimality_gap(best_length, lower_bound) <= gap)) return true;
+            return (time_limit > 0) &&
+                   (std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count() >= time_limit);
+        }
+    };
+
+} // mhe
+
+#endif //MHE_LOWER_BOUND_H
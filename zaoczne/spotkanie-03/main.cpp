@@ -2,18 +2,37 @@
 #include <algorithm>
 #include <array>
 #include <chrono>
+#include <functional>
 #include <iomanip>
 #include <iostream>
 #include <list>
 #include <map>
 #include <memory>
 #include <numeric>
+#include <optional>
 #include <random>
 #include <set>
+#include <span>
+#include <stdexcept>
 #include <string>
+#include <type_traits>
 #include <vector>
 
+#include "branch_and_bound.h"
+#include "checkpoint.h"
+#include "construction.h"
+#include "counter_rng.h"
+#include "crossover.h"
+#include "fixed_solution_t.h"
+#include "held_karp.h"
+#include "local_search.h"
+#include "lower_bound.h"
+#include "problem_file.h"
+#include "moves.h"
+#include "neighbourhood.h"
+#include "population_arena.h"
 #include "solution_t.h"
+#include "tabu_search.h"
 #include <tuple>
 //std::random_device rd;
 
@@ -41,232 +60,412 @@ solution_t brute_force(solution_t start_point)
     return best_solution;
 }
 
+template <class MOVE = swap_move>
 solution_t random_hillclimb(solution_t solution)
 {
+    double cost = solution.goal();
     for (int i = 0; i < 5040; i++) {
-        auto new_solution = solution.random_modify(rgen);
-        if (new_solution.goal() <= solution.goal()) {
-            solution = new_solution;
-            std::cout << i << " " << solution << "  " << solution.goal() << std::endl;
+        auto move = MOVE::random(solution, rgen);
+        double delta = move.delta(solution);
+        if (delta <= 0) {
+            move.apply(solution);
+            cost += delta;
+            std::cout << i << " " << solution << "  " << cost << std::endl;
         }
     }
     return solution;
 }
 
+template <class MOVE = swap_move>
 solution_t deterministic_hillclimb(solution_t solution)
 {
+    double cost = solution.goal();
     for (int i = 0; i < 5040; i++) {
-        auto new_solution = solution.best_neighbour();
-        if (new_solution.goal() <= solution.goal()) {
-            solution = new_solution;
-            std::cout << i << " " << solution << "  " << solution.goal() << std::endl;
+        auto best = best_improvement<MOVE>(solution);
+        if (best && best->delta <= 0) {
+            best->move.apply(solution);
+            cost += best->delta;
+            std::cout << i << " " << solution << "  " << cost << std::endl;
         }
     }
     return solution;
 }
 
+template <class MOVE = swap_move>
 solution_t tabu_search(solution_t solution)
 {
-    std::list<solution_t> tabu_list;
     std::set<solution_t> tabu_set;
-
-    tabu_list.push_back(solution);
     tabu_set.insert(solution);
 
+    auto current = solution;
+    double current_cost = current.goal();
     solution_t best_globally = solution;
+    double best_cost = current_cost;
+    solution_t scratch = current;
+    // the cost is tracked in current_cost; without the cached goal the apply and undo
+    // of the tabu check do not compute the move delta again
+    current.invalidate_goal();
     for (int i = 0; i < 5040; i++) {
-        auto neighbours = tabu_list.back().generate_neighbours();
-
-        neighbours.erase(std::remove_if(neighbours.begin(),
-                             neighbours.end(),
-                             [&](solution_t x) { return tabu_set.contains(x); }),
-            neighbours.end());
-        if (neighbours.size() == 0) {
+        // the neighbour is visited in place to check the tabu, and then the move is reverted;
+        // moves that cannot be reverted cheaply are checked on a reused buffer
+        auto next = best_improvement<MOVE>(current, [&](const MOVE& move) {
+            if constexpr (requires { move.undo(current); }) {
+                move.apply(current);
+                bool is_tabu = tabu_set.contains(current);
+                move.undo(current);
+                return !is_tabu;
+            } else {
+                std::copy(current.cbegin(), current.cend(), scratch.begin());
+                move.apply(scratch);
+                return !tabu_set.contains(scratch);
+            }
+        });
+        if (!next) {
             std::cout << "Ate my tail..." << std::endl;
             return best_globally;
         }
-        auto next_solution = *std::max_element(neighbours.begin(), neighbours.end(), [](auto l, auto r) {
-            return l.goal() > r.goal();
-        });
+        next->move.apply(current);
+        current_cost += next->delta;
 
-        if (next_solution.goal() <= best_globally.goal()) {
-            best_globally = next_solution;
-            std::cout << i << " " << best_globally << "  " << best_globally.goal() << std::endl;
+        if (current_cost <= best_cost) {
+            best_globally = current;
+            best_cost = current_cost;
+            std::cout << i << " " << best_globally << "  " << best_cost << std::endl;
         }
-        tabu_list.push_back(next_solution);
-        tabu_set.insert(next_solution);
+        tabu_set.insert(current);
     }
     return best_globally;
 }
 
-solution_t sim_annealing(const solution_t solution, std::function<double(int)> T)
+template <class MOVE = swap_move>
+solution_t sim_annealing(const solution_t solution, std::function<double(int)> T, int iterations = 5040, const stop_condition_t& stop = {})
 {
     auto best_solution = solution; ///< globally best
     auto s = solution;             ///< current solution
-
-    for (int i = 1; i < 5040; i++) {
-        auto new_solution = s.random_modify(rgen);
-        if (new_solution.goal() <= s.goal()) {
-            s = new_solution;
-            if (new_solution.goal() <= best_solution.goal()) {
+    double best_cost = best_solution.goal();
+    double cost = best_cost;
+
+    for (int i = 1; (i < iterations) && !stop.reached(best_cost); i++) {
+        auto move = MOVE::random(s, rgen);
+        double delta = move.delta(s);
+        if (delta <= 0) {
+            move.apply(s);
+            cost += delta;
+            if (cost <= best_cost) {
                 best_solution = s;
+                best_cost = cost;
                 std::cout << "*";
             }
-            std::cout << i << " " << s << "  " << s.goal() << std::endl;
+            std::cout << i << " " << s << "  " << cost << std::endl;
         } else {
             std::uniform_real_distribution<double> u(0.0, 1.0);
-            if (u(rgen) < std::exp(-std::abs(new_solution.goal() - s.goal()) / T(i))) {
-                s = new_solution;
+            if (u(rgen) < std::exp(-std::abs(delta) / T(i))) {
+                move.apply(s);
+                cost += delta;
             }
         }
     }
     return best_solution;
 }
 
+/**
+ * The operators of generic_algorithm. They work in place on the two population buffers
+ * that generic_algorithm allocates once and swaps every generation, so the tours are
+ * only copied from the parents into the offspring, into the memory they already have.
+ * selection, crossover, mutation and fitness are called in parallel on the chunks of
+ * the population, so they must not modify the config. The random numbers come from
+ * keys.rng(i, operator) for the individual i of the chunk.
+ */
 template <class T>
 class genetic_algorithm_config_t
 {
 public:
     int population_size;
-    virtual bool termination_condition(std::vector<solution_t>, std::vector<double>& fitnesses) = 0;
+    virtual bool termination_condition(std::span<const T> population, std::span<const double> fitnesses) = 0;
     virtual std::vector<T> get_initial_population() = 0;
-    virtual double fitness(T) = 0;
-    virtual std::vector<T> selection(std::vector<double>, std::vector<T>, std::mt19937& rgen) = 0;
-    virtual std::vector<T> crossover(std::vector<T>, std::mt19937& rgen) = 0;
-    virtual std::vector<T> mutation(std::vector<T>, std::mt19937& rgen) = 0;
+    virtual double fitness(const T&) = 0;
+    /// fills parents with the indices of the selected individuals, fitnesses are of the whole population
+    virtual void selection(std::span<const double> fitnesses, std::span<int> parents, const generation_keys_t& keys) = 0;
+    /// offspring[i] and offspring[i + 1] come from population[parents[i]] and population[parents[i + 1]]
+    virtual void crossover(std::span<const T> population, std::span<const int> parents, std::span<T> offspring, const generation_keys_t& keys) = 0;
+    virtual void mutation(std::span<T> offspring, const generation_keys_t& keys) = 0;
+    /// called after every generation, e.g. to save a checkpoint, keys are of the next one
+    virtual void after_generation(std::span<const T> /*population*/, std::span<const double> /*fitnesses*/, const generation_keys_t& /*keys*/) {}
+};
+
+
+/// the crossover operators of crossover.h
+enum class crossover_operator_t {
+    pmx,
+    ox,
+    cx,
+    pos
+};
+
+enum class mutation_operator_t {
+    swap,
+    two_opt,
+    or_opt
+};
+
+enum class local_search_method_t {
+    two_opt_or_opt,
+    lin_kernighan
 };
 
+/// pmx, ox, cx or pos (position based), pmx for the other names
+crossover_operator_t crossover_operator_by_name(const std::string& name)
+{
+    if (name == "ox") return crossover_operator_t::ox;
+    if (name == "cx") return crossover_operator_t::cx;
+    if (name == "pos") return crossover_operator_t::pos;
+    return crossover_operator_t::pmx;
+}
+
+/// swap, 2opt or oropt, swap for the other names
+mutation_operator_t mutation_operator_by_name(const std::string& name)
+{
+    if (name == "2opt") return mutation_operator_t::two_opt;
+    if (name == "oropt") return mutation_operator_t::or_opt;
+    return mutation_operator_t::swap;
+}
+
+/// 2opt (2-opt + Or-opt) or lk (Lin-Kernighan), 2opt for the other names
+local_search_method_t local_search_method_by_name(const std::string& name)
+{
+    return (name == "lk") ? local_search_method_t::lin_kernighan : local_search_method_t::two_opt_or_opt;
+}
 
-class tsp_config_t : public genetic_algorithm_config_t<solution_t>
+template <class SOLUTION = solution_t>
+class tsp_config_t : public genetic_algorithm_config_t<SOLUTION>
 {
 public:
     int iteration;
     int max_iterations;
-    problem_t problem;
+    basic_problem_handle_t<typename SOLUTION::problem_type> problem;
 
     double p_crossover;
     double p_mutation;
-    tsp_config_t(int iter, int pop_size, double p_crossover_, double p_mutation_, problem_t problem_, std::mt19937& rgen)
+    crossover_operator_t crossover_operator = crossover_operator_t::pmx;
+    mutation_operator_t mutation_operator = mutation_operator_t::swap;
+    double p_local_search = 0.0; ///< probability of the local search improvement of the offspring
+    local_search_method_t local_search_method = local_search_method_t::two_opt_or_opt;
+    int lin_kernighan_depth = default_lin_kernighan_depth;
+    seeding_t seeding; ///< the initial population from construction heuristics, random by default
+    stop_condition_t stop; ///< the time limit and the gap to the lower bound, besides max_iterations
+    std::shared_ptr<checkpoint_writer_t> checkpoint_writer; ///< no checkpoints if empty
+    std::shared_ptr<const problem_file_t> checkpoint_problem;
+    int checkpoint_every = 100; ///< generations between the checkpoints
+    const checkpoint_t* resumed = nullptr; ///< the population to start from instead of a new one
+    tsp_config_t(int iter, int pop_size, double p_crossover_, double p_mutation_, basic_problem_handle_t<typename SOLUTION::problem_type> problem_, std::mt19937& /*rgen*/)
     {
         max_iterations = iter;
         iteration = 0;
-        population_size = pop_size;
+        this->population_size = pop_size;
         problem = problem_;
         p_mutation = p_mutation_;
         p_crossover = p_crossover_;
     }
-    virtual bool termination_condition(std::vector<solution_t>, std::vector<double>& fitnesses)
+    virtual bool termination_condition(std::span<const SOLUTION>, std::span<const double> fitnesses)
     {
         iteration++;
-        return iteration <= max_iterations;
+        double best_goal = 1.0 / *std::max_element(fitnesses.begin(), fitnesses.end()) - 1;
+        return (iteration <= max_iterations) && !stop.reached(best_goal);
+    }
+
+    /// continues the run saved in the checkpoint, its seed is given to the genetic algorithm
+    void resume(const checkpoint_t& checkpoint)
+    {
+        resumed = &checkpoint;
+        iteration = checkpoint.iteration;
+        this->population_size = checkpoint.goals.size();
     }
 
-    virtual std::vector<solution_t> get_initial_population()
+    virtual std::vector<SOLUTION> get_initial_population()
     {
-        std::vector<solution_t> ret;
-        for (int i = 0; i < population_size; i++) {
-            ret.push_back(solution_t::random_solution(problem, rgen));
+        std::vector<SOLUTION> ret;
+        if (resumed) {
+            const int n = problem->size();
+            for (int i = 0; i < this->population_size; i++) {
+                ret.push_back(SOLUTION::for_problem(problem));
+                ret.back().assign(resumed->population.begin() + i * n, resumed->population.begin() + (i + 1) * n);
+                // the goals are computed again from the validated tours, not trusted from the file
+                ret.back().goal();
+            }
+            return ret;
+        }
+        if (seeding.hilbert + seeding.greedy + seeding.nearest_neighbour <= 0.0) {
+            for (int i = 0; i < this->population_size; i++) {
+                ret.push_back(SOLUTION::random_solution(problem, rgen));
+            }
+            return ret;
+        }
+        auto candidates = problem->candidates ? problem->candidates : problem->nearest_candidates(default_candidates);
+        for (auto& tour : seed_population(*problem, *candidates, this->population_size, seeding, rgen)) {
+            ret.push_back(SOLUTION::for_problem(problem));
+            ret.back().assign(tour.begin(), tour.end());
         }
         return ret;
     };
 
 
-    virtual double fitness(solution_t solution)
+    virtual double fitness(const SOLUTION& solution)
     {
         return 1.0 / (1 + solution.goal());
     };
 
-    virtual std::vector<solution_t> selection(std::vector<double> fitnesses, std::vector<solution_t> population, std::mt19937& rgen)
+    virtual void selection(std::span<const double> fitnesses, std::span<int> parents, const generation_keys_t& keys)
     {
-        std::vector<solution_t> ret;
-        while (ret.size() < population.size()) {
-            std::uniform_int_distribution<int> dist(0, population.size() - 1);
+        std::uniform_int_distribution<int> dist(0, fitnesses.size() - 1);
+        for (int i = 0; i < parents.size(); i++) {
+            auto rgen = keys.rng(i, random_operator_t::selection);
             int a_idx = dist(rgen);
             int b_idx = dist(rgen);
-            if (fitnesses[a_idx] >= fitnesses[b_idx])
-                ret.push_back(population[a_idx]);
+            parents[i] = (fitnesses[a_idx] >= fitnesses[b_idx]) ? a_idx : b_idx;
+        }
+    }
+
+    /**
+     * The crossover operator of the parents a and b, the children are written to child_a
+     * and child_b, with the workspace of the thread. For the tours and the population_arena_t
+     * rows. Returns false if the cuts are equal, then the children are not written.
+     */
+    template <class PARENT, class CHILD, class RGEN>
+    bool crossover(const PARENT& a, const PARENT& b, CHILD& child_a, CHILD& child_b, RGEN& rgen)
+    {
+        auto& workspace = thread_crossover_workspace();
+        switch (crossover_operator) {
+        case crossover_operator_t::cx:
+            cycle_crossover(a, b, child_a, child_b, workspace);
+            break;
+        case crossover_operator_t::pos:
+            position_based_crossover(a, b, child_a, child_b, rgen, workspace);
+            break;
+        case crossover_operator_t::pmx:
+        case crossover_operator_t::ox: {
+            std::uniform_int_distribution<int> distr(0, a.size() - 1);
+            int cuts[2] = {distr(rgen), distr(rgen)};
+            if (cuts[0] == cuts[1]) return false;
+            if (cuts[0] > cuts[1]) std::swap(cuts[0], cuts[1]);
+            if (crossover_operator == crossover_operator_t::ox)
+                order_crossover(a, b, cuts[0], cuts[1], child_a, child_b, workspace);
             else
-                ret.push_back(population[b_idx]);
+                partially_mapped_crossover(a, b, cuts[0], cuts[1], child_a, child_b, workspace);
+            break;
         }
-        return ret;
+        }
+        child_a.invalidate_goal();
+        child_b.invalidate_goal();
+        return true;
     }
 
-    std::pair<solution_t, solution_t> crossover(const std::pair<solution_t, solution_t>& solutions, std::mt19937& rd_generator)
+    /// the mutation operator, for the tours and the population_arena_t rows
+    template <class TOUR, class RGEN>
+    void mutate(TOUR& e, RGEN& rgen)
     {
-        using namespace std;
-        std::vector<solution_t> offspring = {solutions.first, solutions.second};
-        uniform_int_distribution<int> distr(0, solutions.first.size() - 1);
-        int cuts[2] = {distr(rd_generator), distr(rd_generator)};
-        if (cuts[0] == cuts[1]) return solutions;
-        if (cuts[0] > cuts[1]) swap(cuts[0], cuts[1]);
-
-        map<int, int> taken_cities[2];
-
-        for (int i = cuts[0]; i < cuts[1]; i++) {
-            swap(offspring[0][i], offspring[1][i]);
-            taken_cities[0][offspring[0][i]] = offspring[1][i];
-            taken_cities[1][offspring[1][i]] = offspring[0][i];
+        switch (mutation_operator) {
+        case mutation_operator_t::two_opt:
+            two_opt_move::random(e, rgen).apply(e);
+            break;
+        case mutation_operator_t::or_opt:
+            or_opt_move::random(e, rgen).apply(e);
+            break;
+        case mutation_operator_t::swap:
+            swap_move::random(e, rgen).apply(e);
+            break;
         }
-        for (int v = 0; v < 2; v++)
-            for (int i = 0; i < offspring[0].size(); i++) {
-                if (i == cuts[0]) {
-                    i = cuts[1] - 1;
-                    continue;
-                }
-                while (taken_cities[v].count(offspring[v][i])) {
-                    offspring[v][i] = taken_cities[v].at(offspring[v][i]);
-                }
-            }
-        return {offspring[0], offspring[1]};
     }
 
-    virtual std::vector<solution_t> crossover(std::vector<solution_t> pop, std::mt19937& rgen)
+    virtual void crossover(std::span<const SOLUTION> population, std::span<const int> parents, std::span<SOLUTION> offspring, const generation_keys_t& keys)
     {
-        std::vector<solution_t> offspring;
-        for (int i = 0; i < pop.size(); i += 2) {
-            std::uniform_real_distribution<double> distr(0.0, 1.0);
-            if (distr(rgen) > p_mutation) {
-                auto [a, b] = crossover(std::make_pair(pop.at(i), pop.at(i + 1)), rgen);
-                offspring.push_back(a);
-                offspring.push_back(b);
-            } else {
-                offspring.push_back(pop.at(i));
-                offspring.push_back(pop.at(i + 1));
+        std::uniform_real_distribution<double> distr(0.0, 1.0);
+        for (int i = 0; i + 1 < offspring.size(); i += 2) {
+            auto rgen = keys.rng(i, random_operator_t::crossover);
+            auto& a = population[parents[i]];
+            auto& b = population[parents[i + 1]];
+            // the children are copies of the parents when there is no crossover
+            if (!(distr(rgen) > p_mutation) || !crossover(a, b, offspring[i], offspring[i + 1], rgen)) {
+                offspring[i] = a;
+                offspring[i + 1] = b;
             }
         }
-        return offspring;
+        if (offspring.size() % 2)
+            offspring.back() = population[parents.back()];
     };
-    virtual std::vector<solution_t> mutation(std::vector<solution_t> sol, std::mt19937& rgen)
+    virtual void mutation(std::span<SOLUTION> offspring, const generation_keys_t& keys)
     {
-        std::vector<solution_t> ret(sol.size());
-        std::transform(sol.begin(), sol.end(), ret.begin(), [&](auto e) {
-            std::uniform_real_distribution<double> distr(0.0, 1.0);
+        std::uniform_real_distribution<double> distr(0.0, 1.0);
+        for (int i = 0; i < offspring.size(); i++) {
+            auto& e = offspring[i];
+            auto rgen = keys.rng(i, random_operator_t::mutation);
             if (distr(rgen) > p_mutation)
-                return e.random_modify(rgen);
-            else
-                return e;
-        });
-        return ret;
+                mutate(e, rgen);
+            if ((p_local_search > 0.0) && (distr(rgen) < p_local_search)) {
+                if (local_search_method == local_search_method_t::lin_kernighan)
+                    lin_kernighan(e, lin_kernighan_depth);
+                else
+                    local_search(e, true, true);
+            }
+        }
     };
+
+    virtual void after_generation(std::span<const SOLUTION> population, std::span<const double> /*fitnesses*/, const generation_keys_t& keys)
+    {
+        if (!checkpoint_writer || (checkpoint_every <= 0) || (iteration % checkpoint_every != 0)) return;
+        checkpoint_t checkpoint;
+        checkpoint.problem = checkpoint_problem;
+        checkpoint.iteration = iteration;
+        checkpoint.population.reserve(population.size() * problem->size());
+        for (auto& e : population) {
+            checkpoint.population.insert(checkpoint.population.end(), e.cbegin(), e.cend());
+            checkpoint.goals.push_back(e.goal());
+        }
+        checkpoint.seed = keys.seed;
+        checkpoint.integer_distances = std::is_integral_v<typename SOLUTION::distance_type>;
+        checkpoint_writer->write(std::move(checkpoint));
+    }
 };
 
 
+/**
+ * The generations are computed in parallel. Every chunk of generation_chunk offspring
+ * selects its parents, and is crossed, mutated and evaluated by one thread. The random
+ * numbers depend only on keys, the generation and the individual, so the result is
+ * the same for any number of threads. keys are of the first generation: the seed, and
+ * the number of the generations before, if the run is resumed. The fitnesses of the
+ * offspring go to the second buffer, because the other chunks still select from the
+ * current ones.
+ */
 template <class T>
-solution_t generic_algorithm(genetic_algorithm_config_t<T>& cfg, int conv_curve, std::mt19937& rgen)
+T generic_algorithm(genetic_algorithm_config_t<T>& cfg, int conv_curve, generation_keys_t keys)
 {
     auto population = cfg.get_initial_population();
-    std::vector<double> fitnesses;
+    // the second buffer gets the offspring, the tours are allocated only here
+    auto offspring = population;
+    std::vector<int> parents(population.size());
+    std::vector<double> fitnesses(population.size());
+    std::vector<double> offspring_fitnesses(population.size());
+    const int chunks = (population.size() + generation_chunk - 1) / generation_chunk;
     int iteration = 0;
+#pragma omp parallel for schedule(dynamic, generation_chunk)
     for (int i = 0; i < population.size(); i++)
-        fitnesses.push_back(cfg.fitness(population[i]));
+        fitnesses[i] = cfg.fitness(population[i]);
     while (cfg.termination_condition(population, fitnesses)) {
-        auto parents = cfg.selection(fitnesses, population, rgen);
-        auto offspring = cfg.crossover(parents, rgen);
-        offspring = cfg.mutation(offspring, rgen);
-        population = offspring;
-        fitnesses.clear();
-        for (int i = 0; i < population.size(); i++)
-            fitnesses.push_back(cfg.fitness(population[i]));
+#pragma omp parallel for schedule(dynamic, 1)
+        for (int c = 0; c < chunks; c++) {
+            const int first = c * generation_chunk;
+            const int count = std::min<int>(generation_chunk, population.size() - first);
+            auto chunk_parents = std::span<int>(parents).subspan(first, count);
+            auto chunk_offspring = std::span<T>(offspring).subspan(first, count);
+            const auto chunk_keys = keys.chunk(first);
+            cfg.selection(fitnesses, chunk_parents, chunk_keys);
+            cfg.crossover(population, chunk_parents, chunk_offspring, chunk_keys);
+            cfg.mutation(chunk_offspring, chunk_keys);
+            for (int i = first; i < first + count; i++)
+                offspring_fitnesses[i] = cfg.fitness(offspring[i]);
+        }
+        population.swap(offspring);
+        fitnesses.swap(offspring_fitnesses);
         if (conv_curve > 0) {
             if ((iteration % conv_curve) == 0) {
                 double average = std::accumulate(fitnesses.begin(), fitnesses.end(), 0.0) / fitnesses.size();
@@ -274,28 +473,181 @@ solution_t generic_algorithm(genetic_algorithm_config_t<T>& cfg, int conv_curve,
             }
         }
         iteration++;
+        keys.generation++;
+        cfg.after_generation(population, fitnesses, keys);
     }
-    return *std::max_element(population.begin(), population.end(), [&](T l, T r) { return cfg.fitness(l) > cfg.fitness(r); });
+    return population[std::max_element(fitnesses.begin(), fitnesses.end()) - fitnesses.begin()];
 }
 
+/**
+ * The same genetic algorithm as generic_algorithm with tsp_config_t, PMX and swap mutation,
+ * specialised for exactly N cities. Tours are std::array and the loops over them are
+ * unrolled, so there are no heap allocations inside of the generation loop. The generations
+ * are computed in the same parallel chunks and with the same random numbers as in
+ * arena_genetic_algorithm, so the seed gives the same run for any number of threads.
+ */
+template <std::size_t N>
+solution_t fixed_size_genetic_algorithm(tsp_config_t<solution_t>& cfg, int conv_curve, generation_keys_t keys)
+{
+    using fixed_t = fixed_solution_t<N>;
+    const fixed_problem_t<N> problem(*cfg.problem);
+    std::vector<fixed_t> population(cfg.population_size);
+    {
+        auto initial = cfg.get_initial_population();
+        for (int i = 0; i < population.size(); i++)
+            std::copy(initial[i].cbegin(), initial[i].cend(), population[i].begin());
+    }
+    std::vector<fixed_t> offspring(population.size());
+    std::vector<int> parents(population.size());
+    std::vector<double> fitnesses(population.size());
+    std::vector<double> offspring_fitnesses(population.size());
+    const int chunks = (population.size() + generation_chunk - 1) / generation_chunk;
+    for (int i = 0; i < population.size(); i++)
+        fitnesses[i] = 1.0 / (1 + population[i].goal(problem));
+    int iteration = 0;
+    while (cfg.termination_condition({}, fitnesses)) {
+#pragma omp parallel for schedule(dynamic, 1)
+        for (int c = 0; c < chunks; c++) {
+            const int first = c * generation_chunk;
+            const int end = std::min<int>(first + generation_chunk, population.size());
+            std::uniform_real_distribution<double> u(0.0, 1.0);
+            std::uniform_int_distribution<int> cut(0, N - 1);
+            cfg.selection(fitnesses, std::span<int>(parents).subspan(first, end - first), keys.chunk(first));
+            // the same decisions as tsp_config_t::crossover and tsp_config_t::mutation
+            for (int i = first; i + 1 < end; i += 2) {
+                auto rgen = keys.rng(i, random_operator_t::crossover);
+                auto& a = population[parents[i]];
+                auto& b = population[parents[i + 1]];
+                offspring[i] = a;
+                offspring[i + 1] = b;
+                if (!(u(rgen) > cfg.p_mutation)) continue;
+                int cuts[2] = {cut(rgen), cut(rgen)};
+                if (cuts[0] == cuts[1]) continue;
+                if (cuts[0] > cuts[1]) std::swap(cuts[0], cuts[1]);
+                std::tie(offspring[i], offspring[i + 1]) = fixed_t::pmx(a, b, cuts[0], cuts[1]);
+            }
+            if ((end - first) % 2)
+                offspring[end - 1] = population[parents[end - 1]];
+            for (int i = first; i < end; i++) {
+                auto rgen = keys.rng(i, random_operator_t::mutation);
+                if (u(rgen) > cfg.p_mutation) offspring[i].random_modify(rgen);
+                offspring_fitnesses[i] = 1.0 / (1 + offspring[i].goal(problem));
+            }
+        }
+        population.swap(offspring);
+        fitnesses.swap(offspring_fitnesses);
+        if ((conv_curve > 0) && ((iteration % conv_curve) == 0)) {
+            double average = std::accumulate(fitnesses.begin(), fitnesses.end(), 0.0) / fitnesses.size();
+            std::cout << iteration << " " << average << std::endl;
+        }
+        iteration++;
+        keys.generation++;
+    }
+    auto best = std::max_element(fitnesses.begin(), fitnesses.end()) - fitnesses.begin();
+    auto result = solution_t::for_problem(cfg.problem);
+    result.assign(population[best].begin(), population[best].end());
+    return result;
+}
 
-solution_t shortest_distance(solution_t solution)
+/**
+ * The same genetic algorithm as generic_algorithm with tsp_config_t, without the local
+ * search and the checkpoints. The generations are two population_arena_t blocks of CITY
+ * indices, the offspring are copied and modified in the rows of the next one, in the
+ * same parallel chunks and with the same random numbers as in generic_algorithm.
+ */
+template <class CITY, class SOLUTION>
+std::vector<int> arena_genetic_algorithm(tsp_config_t<SOLUTION>& cfg, int conv_curve, generation_keys_t keys)
 {
-    solution_t result = solution;
-    auto& problem = *solution.problem;
-    solution.erase(solution.begin());
-    for (int i = 1; i < result.size(); i++) {
-        auto found = std::min_element(solution.begin(), solution.end(), [&](auto a, auto b) {
-            double dist_a = len(problem[result[i - 1]] - problem[a]);
-            double dist_b = len(problem[result[i - 1]] - problem[b]);
-            return dist_a < dist_b;
-        });
-        result[i] = *found;
-        solution.erase(found);
+    using arena_t = population_arena_t<CITY, typename SOLUTION::problem_type>;
+    arena_t population(cfg.problem, cfg.population_size);
+    {
+        auto initial = cfg.get_initial_population();
+        for (int i = 0; i < population.size(); i++)
+            population.assign(i, initial[i], initial[i].cached_goal());
     }
+    arena_t offspring(cfg.problem, population.size());
+    std::vector<int> parents(population.size());
+    std::vector<double> fitnesses(population.size());
+    std::vector<double> offspring_fitnesses(population.size());
+    const int chunks = (population.size() + generation_chunk - 1) / generation_chunk;
+#pragma omp parallel for schedule(dynamic, generation_chunk)
+    for (int i = 0; i < population.size(); i++)
+        fitnesses[i] = 1.0 / (1 + population.goal(i));
+    int iteration = 0;
+    while (cfg.termination_condition({}, fitnesses)) {
+#pragma omp parallel for schedule(dynamic, 1)
+        for (int c = 0; c < chunks; c++) {
+            const int first = c * generation_chunk;
+            const int end = std::min(first + generation_chunk, population.size());
+            std::uniform_real_distribution<double> u(0.0, 1.0);
+            cfg.selection(fitnesses, std::span<int>(parents).subspan(first, end - first), keys.chunk(first));
+            // the same decisions as tsp_config_t::crossover and tsp_config_t::mutation
+            for (int i = first; i + 1 < end; i += 2) {
+                auto rgen = keys.rng(i, random_operator_t::crossover);
+                auto a = offspring.row(i);
+                auto b = offspring.row(i + 1);
+                if (!(u(rgen) > cfg.p_mutation) || !cfg.crossover(population.row(parents[i]), population.row(parents[i + 1]), a, b, rgen)) {
+                    offspring.copy_row(i, population, parents[i]);
+                    offspring.copy_row(i + 1, population, parents[i + 1]);
+                }
+            }
+            if ((end - first) % 2)
+                offspring.copy_row(end - 1, population, parents[end - 1]);
+            for (int i = first; i < end; i++) {
+                auto rgen = keys.rng(i, random_operator_t::mutation);
+                if (u(rgen) > cfg.p_mutation) {
+                    auto e = offspring.row(i);
+                    cfg.mutate(e, rgen);
+                }
+                offspring_fitnesses[i] = 1.0 / (1 + offspring.goal(i));
+            }
+        }
+        population.swap(offspring);
+        fitnesses.swap(offspring_fitnesses);
+        if ((conv_curve > 0) && ((iteration % conv_curve) == 0)) {
+            double average = std::accumulate(fitnesses.begin(), fitnesses.end(), 0.0) / fitnesses.size();
+            std::cout << iteration << " " << average << std::endl;
+        }
+        iteration++;
+        keys.generation++;
+    }
+    auto best = population.cities(std::max_element(fitnesses.begin(), fitnesses.end()) - fitnesses.begin());
+    return {best.begin(), best.end()};
+}
+
+/// the problem sizes that have the compile-time specialised genetic algorithm
+using fixed_problem_sizes = std::index_sequence<8, 10, 12, 16, 20, 24, 30, 32, 40, 48, 50, 64>;
+
+/// runs fixed_size_genetic_algorithm<N> if the problem size is one of NS
+template <std::size_t... NS>
+std::optional<solution_t> fixed_size_genetic_algorithm(std::index_sequence<NS...>, tsp_config_t<solution_t>& cfg, int conv_curve, const generation_keys_t& keys)
+{
+    std::optional<solution_t> result;
+    const std::size_t n = cfg.problem->size();
+    ((n == NS && (result = fixed_size_genetic_algorithm<NS>(cfg, conv_curve, keys), true)) || ...);
     return result;
 }
 
+
+template <class SOLUTION>
+SOLUTION shortest_distance(SOLUTION solution)
+{
+    auto tour = nearest_neighbour_tour(*solution.problem, solution.front());
+    solution.assign(tour.begin(), tour.end());
+    return solution;
+}
+
+/// the start point of the standalone local search methods
+template <class SOLUTION>
+SOLUTION greedy_edge_solution(SOLUTION solution)
+{
+    auto& problem = *solution.problem;
+    auto candidates = problem.candidates ? problem.candidates : problem.nearest_candidates(default_candidates);
+    auto tour = greedy_edge_tour(problem, *candidates);
+    solution.assign(tour.begin(), tour.end());
+    return solution;
+}
+
 std::ostream& print_solution_for_graphviz(std::ostream& o, const solution_t v)
 {
     auto pow_modulo = [](unsigned int a, unsigned int b, unsigned int mod) {
@@ -335,43 +687,260 @@ int main(int argc, char** argv)
     auto conv_curve = arg(argc, argv, "conv_curve", 0, "how often show data to convergence curve");
     auto result_fit = arg(argc, argv, "result_fit", false, "print result fitness");
     auto count_time = arg(argc, argv, "count_time", false, "print time");
+    auto print_evaluations = arg(argc, argv, "print_evaluations", false, "print the number of real and cached goal evaluations, the fixed size GA does not count them");
 
     auto problem_size = arg(argc, argv, "problem_size", 30, "the number of cities");
+    auto problem_file = arg(argc, argv, "problem_file", std::string(""), "TSPLIB .tsp or \"name lat lon\" file; random cities if empty");
     auto iterations = arg(argc, argv, "iterations", 1000, "iterations count");
     auto pop_size = arg(argc, argv, "pop_size", 5000, "population size");
+    auto seed = arg(argc, argv, "seed", 0, "random seed, the GA gives the same result for it on any number of threads; 0 for a random one");
     auto p_crossover = arg(argc, argv, "p_crossover", 0.1, "crossover probability");
     auto p_mutation = arg(argc, argv, "p_mutation", 0.1, "mutation probability");
+    auto distance_cache = arg(argc, argv, "distance_cache", true, "precompute the distance matrix");
+    auto candidates = arg(argc, argv, "candidates", 8, "nearest neighbours checked by the local search");
+    auto crossover = arg(argc, argv, "crossover", std::string("pmx"), "crossover operator: pmx, ox (order), cx (cycle), pos (position based)");
+    auto mutation = arg(argc, argv, "mutation", std::string("swap"), "mutation operator: swap, 2opt, oropt");
+    auto method = arg(argc, argv, "method", std::string("ga"), "optimization method: ga (genetic algorithm), lk (Lin-Kernighan) or tabu (move based tabu search) from the greedy edge tour, exact (Held-Karp, up to about 24 cities), bnb (branch and bound, about 30-80 cities)");
+    auto p_local_search = arg(argc, argv, "p_local_search", 0.0, "probability of the local search improvement of offspring");
+    auto local_search_method = arg(argc, argv, "local_search", std::string("2opt"), "offspring local search: 2opt (2-opt + Or-opt), lk (Lin-Kernighan)");
+    auto lin_kernighan_depth = arg(argc, argv, "lk_depth", default_lin_kernighan_depth, "the number of exchanges in one Lin-Kernighan move");
+    auto bnb_nodes = arg(argc, argv, "bnb_nodes", (int) branch_and_bound_config_t().node_limit, "the branch and bound stops with a gap after that many nodes");
+    auto tabu_iterations = arg(argc, argv, "tabu_iterations", tabu_search_config_t().iterations, "moves applied by the tabu search");
+    auto tabu_tenure = arg(argc, argv, "tabu_tenure", tabu_search_config_t().tenure, "iterations during which a removed edge is tabu");
+    auto tabu_sample = arg(argc, argv, "tabu_sample", tabu_search_config_t().sample, "cities whose candidate moves are checked in every tabu iteration");
+    auto time_limit = arg(argc, argv, "time_limit", 0.0, "stop the GA and the tabu search after that many seconds, 0 for no limit");
+    auto stop_gap = arg(argc, argv, "stop_gap", -1.0, "stop the GA and the tabu search within that many percent of the lower bound, -1 to not compute the bound");
+    auto print_bound = arg(argc, argv, "print_bound", false, "print the lower bound and the gap of the result");
+    auto checkpoint_file = arg(argc, argv, "checkpoint", std::string(""), "save the GA state to this file in the background, none if empty");
+    auto checkpoint_every = arg(argc, argv, "checkpoint_every", 100, "generations between the checkpoints");
+    auto resume_file = arg(argc, argv, "resume", std::string(""), "continue the GA from this checkpoint, the problem and the metric are read from it");
+    auto compact_tours = arg(argc, argv, "compact_tours", true, "store GA tours with the narrowest city index type");
+    auto arena = arg(argc, argv, "arena", true, "keep the GA population in one flat block when there is no local search and no checkpoints");
+    auto fixed_size = arg(argc, argv, "fixed_size", true, "use the compile-time specialised GA for common problem sizes");
+    auto constructed = arg(argc, argv, "constructed", 0.0, "part of the initial population from Hilbert curve, greedy edge and nearest neighbour tours");
+    auto construction_noise = arg(argc, argv, "construction_noise", 0.1, "randomness of the constructed greedy edge and nearest neighbour tours");
+    auto integer_distances = arg(argc, argv, "integer_distances", false, "optimize the TSPLIB EUC_2D integer tour length");
     if (help) {
         std::cout << "help screen.." << std::endl;
         args_info(std::cout);
         return 0;
     }
 
-    problem_t tsp_problem = generate_problem(problem_size, 10,
-        10, rgen); //{{1.3, 1}, {2.4, 1}, {1.5, 2}, {3.1, 1}, {3.2, 7}, {3.3, 9}, {1.4, 4}};
+    goal_statistics.enabled = print_evaluations;
+    // the errors of the files and the methods end the run with their message
+    try {
+        problem_file_t instance;
+        checkpoint_t resumed;
+        if (!resume_file.empty()) {
+            resumed = load_checkpoint(resume_file);
+            instance = *resumed.problem;
+            // the saved goals are of the metric of the saved run, so it is restored with them
+            if (integer_distances != resumed.integer_distances)
+                std::cerr << "the checkpoint was saved " << (resumed.integer_distances ? "with" : "without")
+                          << " -integer_distances, the run continues with its metric" << std::endl;
+            integer_distances = resumed.integer_distances;
+        } else if (problem_file.empty())
+            instance.cities = generate_problem(problem_size, 10,
+                10, rgen); //{{1.3, 1}, {2.4, 1}, {1.5, 2}, {3.1, 1}, {3.2, 7}, {3.3, 9}, {1.4, 4}};
+        else
+            instance = load_problem_file(problem_file);
+        problem_size = instance.cities.size();
+        // only EUC_2D can be optimized with the double precision distances of the coordinates
+        if (instance.edge_weight_type != edge_weight_t::euc_2d) integer_distances = true;
+
+        tsplib_problem_handle_t integer_problem;
+        if (integer_distances) {
+            tsplib_problem_t tsplib_problem = mhe::tsplib_problem(instance);
+            if (distance_cache && !tsplib_problem.distances) tsplib_problem.precompute_distances();
+            tsplib_problem.precompute_candidates(candidates);
+            integer_problem = register_problem(std::move(tsplib_problem));
+        }
+        // the checkpoints keep the EUC_2D coordinates, or the distance matrix of the other types
+        std::shared_ptr<const problem_file_t> checkpoint_problem;
+        if (!checkpoint_file.empty()) {
+            auto saved = std::make_shared<problem_file_t>(instance);
+            if ((saved->edge_weight_type != edge_weight_t::euc_2d) && saved->weights.empty()) {
+                const int n = saved->cities.size();
+                saved->weights.resize(n * n);
+                for (int a = 0; a < n; a++)
+                    for (int b = 0; b < n; b++)
+                        saved->weights[a * n + b] = integer_problem->distance(a, b);
+                saved->edge_weight_type = edge_weight_t::explicit_matrix;
+            }
+            checkpoint_problem = saved;
+        }
+        problem_t tsp_problem = std::move(instance.cities);
+        if (distance_cache) tsp_problem.precompute_distances();
+        tsp_problem.precompute_coordinates();
+        tsp_problem.precompute_candidates(candidates);
+        auto problem = register_problem(std::move(tsp_problem));
     
-    std::random_device rd;
-    rgen.seed(rd());
-    auto solution = solution_t::random_solution(tsp_problem, rgen);
-    //std::cout << tsp_problem << std::endl;
-    //std::cout << solution << "Start:  " << solution.goal() << std::endl;
-    //solution = random_hillclimb(solution);
-    //solution = brute_force(solution);
-    //solution = shortest_distance(solution);
-    //solution = deterministic_hillclimb(solution);
-    //solution = tabu_search(solution);
-    //solution = sim_annealing(solution, [](int k){return 1000.0/k;});
-    tsp_config_t config(iterations, pop_size, p_mutation, p_crossover, tsp_problem, rgen);
-    auto start = std::chrono::steady_clock::now();
-    solution = generic_algorithm<solution_t>(config, conv_curve, rgen);
-    auto end = std::chrono::steady_clock::now();
-    if (count_time) std::cout << (end - start).count() << " ";
-
-    //*  { 6 0 3 5 2 1 4 }  30.9289 --  19.3343 // { 6 5 4 3 1 0 2 }  18.1745 -- bruteforce */
-    if (print_solution) std::cout << solution << "Result  " << solution.goal() << std::endl;
-    if (print_dot) print_solution_for_graphviz(std::cout, solution.start_from_zero());
-    if (result_fit) {
-        std::cout << solution.goal() << std::endl;
+        std::random_device rd;
+        const std::uint32_t run_seed = (seed != 0) ? seed : rd();
+        rgen.seed(run_seed);
+        auto solution = solution_t::random_solution(problem, rgen);
+        //std::cout << tsp_problem << std::endl;
+        //std::cout << solution << "Start:  " << solution.goal() << std::endl;
+        //solution = random_hillclimb(solution);
+        //solution = brute_force(solution);
+        //solution = shortest_distance(solution);
+        //solution = deterministic_hillclimb(solution);
+        //solution = tabu_search(solution);
+        //solution = sim_annealing(solution, [](int k){return 1000.0/k;});
+        stop_condition_t stop;
+        std::shared_ptr<checkpoint_writer_t> checkpoint_writer;
+        if (!checkpoint_file.empty()) checkpoint_writer = std::make_shared<checkpoint_writer_t>(checkpoint_file);
+        // the operator names are parsed once, the GA switches on them for every individual
+        const auto crossover_operator = crossover_operator_by_name(crossover);
+        const auto mutation_operator = mutation_operator_by_name(mutation);
+        auto configure = [&](auto& config) {
+            config.crossover_operator = crossover_operator;
+            config.mutation_operator = mutation_operator;
+            config.p_local_search = p_local_search;
+            config.local_search_method = local_search_method_by_name(local_search_method);
+            config.lin_kernighan_depth = lin_kernighan_depth;
+            config.seeding = {constructed / 3, constructed / 3, constructed / 3, construction_noise};
+            config.stop = stop;
+            if (!checkpoint_file.empty()) {
+                config.checkpoint_writer = checkpoint_writer;
+                config.checkpoint_problem = checkpoint_problem;
+                config.checkpoint_every = checkpoint_every;
+            }
+            if (!resume_file.empty()) config.resume(resumed);
+        };
+        // the random numbers of the generations, the resumed run continues the saved ones
+        generation_keys_t keys{run_seed};
+        if (!resume_file.empty()) keys = {resumed.seed, (std::uint32_t) resumed.iteration};
+        auto run_genetic_algorithm = [&](auto representation, auto problem) {
+            using SOLUTION = decltype(representation);
+            tsp_config_t<SOLUTION> config(iterations, pop_size, p_mutation, p_crossover, problem, rgen);
+            configure(config);
+            auto best = generic_algorithm<SOLUTION>(config, conv_curve, keys);
+            solution.assign(best.cbegin(), best.cend());
+        };
+        const bool use_arena = arena && (p_local_search <= 0.0) && checkpoint_file.empty() && resume_file.empty();
+        auto run_arena_genetic_algorithm = [&](auto representation, auto problem) {
+            using SOLUTION = decltype(representation);
+            tsp_config_t<SOLUTION> config(iterations, pop_size, p_mutation, p_crossover, problem, rgen);
+            configure(config);
+            std::vector<int> best;
+            if (!compact_tours)
+                best = arena_genetic_algorithm<int>(config, conv_curve, keys);
+            else if (problem_size <= 256)
+                best = arena_genetic_algorithm<std::uint8_t>(config, conv_curve, keys);
+            else if (problem_size <= 65536)
+                best = arena_genetic_algorithm<std::uint16_t>(config, conv_curve, keys);
+            else
+                best = arena_genetic_algorithm<std::uint32_t>(config, conv_curve, keys);
+            solution.assign(best.begin(), best.end());
+        };
+        auto run_fixed_size_genetic_algorithm = [&]() -> bool {
+            if (!fixed_size || integer_distances || !checkpoint_file.empty() || !resume_file.empty() || (crossover_operator != crossover_operator_t::pmx) || (mutation_operator != mutation_operator_t::swap) || (p_local_search > 0.0) || (constructed > 0.0)) return false;
+            tsp_config_t<solution_t> config(iterations, pop_size, p_mutation, p_crossover, problem, rgen);
+            config.stop = stop;
+            auto best = fixed_size_genetic_algorithm(fixed_problem_sizes(), config, conv_curve, keys);
+            if (best) solution = *best;
+            return best.has_value();
+        };
+        auto run_from_greedy_edge_tour = [&](auto improve) {
+            if (!integer_distances) {
+                solution = greedy_edge_solution(solution);
+                improve(solution);
+                return;
+            }
+            auto best = greedy_edge_solution(tsplib_solution_t::for_problem(integer_problem));
+            improve(best);
+            solution.assign(best.cbegin(), best.cend());
+        };
+        tabu_search_config_t tabu_config;
+        tabu_config.iterations = tabu_iterations;
+        tabu_config.tenure = tabu_tenure;
+        tabu_config.sample = tabu_sample;
+        branch_and_bound_config_t branch_and_bound_config;
+        branch_and_bound_config.node_limit = bnb_nodes;
+        // the incumbent comes from the nearest neighbour tour improved by the tabu search
+        auto run_branch_and_bound = [&](auto start) {
+            start.assign(solution.cbegin(), solution.cend());
+            start = shortest_distance(start);
+            move_tabu_search(start, tabu_config, rgen);
+            auto result = branch_and_bound(*start.problem, std::vector<int>(start.cbegin(), start.cend()), branch_and_bound_config);
+            solution.assign(result.tour.begin(), result.tour.end());
+            std::cout << "lower bound " << result.lower_bound << " gap " << (result.gap() * 100) << "%"
+                      << (result.optimal() ? " optimal" : "") << " nodes " << result.nodes << std::endl;
+        };
+        auto start = std::chrono::steady_clock::now();
+        // the bound is computed before the search, its time is counted
+        double lower_bound = 0.0;
+        if ((stop_gap >= 0) || print_bound)
+            lower_bound = integer_distances ? tour_lower_bound(*integer_problem) : tour_lower_bound(*problem);
+        stop.start = start;
+        stop.time_limit = time_limit;
+        if (stop_gap >= 0) {
+            stop.lower_bound = lower_bound;
+            stop.gap = stop_gap / 100;
+        }
+        tabu_config.stop = stop;
+        if (method == "lk")
+            run_from_greedy_edge_tour([&](auto& s) { lin_kernighan(s, lin_kernighan_depth); });
+        else if (method == "tabu")
+            run_from_greedy_edge_tour([&](auto& s) { move_tabu_search(s, tabu_config, rgen); });
+        else if (method == "bnb") {
+            if (integer_distances)
+                run_branch_and_bound(tsplib_solution_t::for_problem(integer_problem));
+            else
+                run_branch_and_bound(solution_t::for_problem(problem));
+        } else if (method == "exact") {
+            const std::size_t cost_size = integer_distances ? sizeof(held_karp_cost_t<tsplib_problem_t>) : sizeof(held_karp_cost_t<problem_t>);
+            if ((problem_size > 40) || (held_karp_memory(problem_size, cost_size) > default_held_karp_memory_limit)) {
+                std::cerr << "-method exact is for up to " << (integer_distances ? 25 : 24)
+                          << " cities, use -method bnb for " << problem_size << std::endl;
+                return 1;
+            }
+            auto tour = integer_distances ? held_karp_tour(*integer_problem) : held_karp_tour(*problem);
+            solution.assign(tour.begin(), tour.end());
+        }
+        else if (integer_distances && use_arena)
+            run_arena_genetic_algorithm(tsplib_solution_t(), integer_problem);
+        else if (integer_distances)
+            run_genetic_algorithm(tsplib_solution_t(), integer_problem);
+        else if (!run_fixed_size_genetic_algorithm()) {
+            if (use_arena)
+                run_arena_genetic_algorithm(solution_t(), problem);
+            else if (!compact_tours)
+                run_genetic_algorithm(solution_t(), problem);
+            else if (problem_size <= inline_solution_capacity)
+                run_genetic_algorithm(inline_solution_t(), problem);
+            else if (problem_size <= solution16_t::max_cities())
+                run_genetic_algorithm(solution16_t(), problem);
+            else
+                run_genetic_algorithm(solution32_t(), problem);
+        }
+        if (checkpoint_writer) checkpoint_writer->wait();
+        auto end = std::chrono::steady_clock::now();
+        if (count_time) std::cout << (end - start).count() << " ";
+
+        //*  { 6 0 3 5 2 1 4 }  30.9289 --  19.3343 // { 6 5 4 3 1 0 2 }  18.1745 -- bruteforce */
+        // with integer distances the result is the exact TSPLIB tour length
+        auto result_goal = [&]() {
+            if (!integer_problem) return solution.goal();
+            auto integer_solution = tsplib_solution_t::for_problem(integer_problem);
+            integer_solution.assign(solution.cbegin(), solution.cend());
+            return integer_solution.goal();
+        };
+        if (print_solution) std::cout << solution << "Result  " << result_goal() << std::endl;
+        if (print_dot) print_solution_for_graphviz(std::cout, solution.start_from_zero());
+        if (result_fit) {
+            std::cout << result_goal() << std::endl;
+        }
+        if (print_bound) {
+            std::cout << "lower bound " << lower_bound << " gap " << (optimality_gap(result_goal(), lower_bound) * 100) << "%" << std::endl;
+        }
+        if (print_evaluations) {
+            std::cout << "evaluations: " << goal_statistics.evaluations << " cached: " << goal_statistics.cached << std::endl;
+        }
+    } catch (const std::exception &e) {
+        std::cerr << e.what() << std::endl;
+        return 1;
     }
     return 0;
 }
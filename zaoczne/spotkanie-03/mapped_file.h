@@ -0,0 +1,56 @@
+#ifndef MHE_MAPPED_FILE_H
+#define MHE_MAPPED_FILE_H
+
+#include <cstddef>
+#include <stdexcept>
+#include <string>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace mhe {
+
+    /// read only view of the whole file, mapped into memory
+    class mapped_file_t {
+    public:
+        explicit mapped_file_t(const std::string &file_name) {
+            int fd = ::open(file_name.c_str(), O_RDONLY);
+            if (fd < 0) throw std::invalid_argument("could not open file " + file_name);
+            struct stat file_stat{};
+            if (::fstat(fd, &file_stat) != 0) {
+                ::close(fd);
+                throw std::invalid_argument("could not read file " + file_name);
+            }
+            length = file_stat.st_size;
+            if (length > 0) {
+                void *mapped = ::mmap(nullptr, length, PROT_READ, MAP_PRIVATE, fd, 0);
+                ::close(fd);
+                if (mapped == MAP_FAILED) throw std::invalid_argument("could not map file " + file_name);
+                ::madvise(mapped, length, MADV_SEQUENTIAL);
+                data = static_cast<const char *>(mapped);
+            } else {
+                ::close(fd);
+            }
+        }
+
+        mapped_file_t(const mapped_file_t &) = delete;
+        mapped_file_t &operator=(const mapped_file_t &) = delete;
+
+        ~mapped_file_t() {
+            if (data) ::munmap(const_cast<char *>(data), length);
+        }
+
+        const char *begin() const { return data; }
+        const char *end() const { return data + length; }
+        std::size_t size() const { return length; }
+
+    private:
+        const char *data = nullptr;
+        std::size_t length = 0;
+    };
+
+} // mhe
+
+#endif //MHE_MAPPED_FILE_H
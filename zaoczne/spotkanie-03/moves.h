@@ -0,0 +1,228 @@
+#ifndef MHE_MOVES_H
+#define MHE_MOVES_H
+
+#include "solution_t.h"
+
+#include <algorithm>
+#include <random>
+#include <utility>
+
+namespace mhe {
+
+    /**
+     * Runs modify() that performs the move m on s. If the goal of s was cached, it is
+     * updated by the move delta, so the tour does not have to be evaluated again.
+     */
+    template<class MOVE, class SOLUTION, class MODIFY>
+    void apply_updating_goal(const MOVE &m, SOLUTION &s, MODIFY &&modify) {
+        auto goal_before = s.cached_goal();
+        double delta = goal_before ? m.delta(s) : 0.0;
+        modify();
+        if (goal_before) s.set_cached_goal(*goal_before + delta);
+    }
+
+    /**
+     * Swap of the cities at positions i and (i+1)%n. This is the move used by
+     * solution_t::random_modify and solution_t::generate_neighbours.
+     *
+     * delta() returns the change of goal() after the move, computed from the
+     * edges that are modified, so it does not depend on the number of cities.
+     */
+    struct swap_move {
+        int i;
+
+        template<class SOLUTION>
+        double delta(const SOLUTION &s) const {
+            const int n = s.size();
+            if (n < 3) return 0.0;
+            auto &p = *s.problem;
+            int a = s[(i + n - 1) % n];
+            int b = s[i];
+            int c = s[(i + 1) % n];
+            int d = s[(i + 2) % n];
+            return p.distance(a, c) + p.distance(b, d) - p.distance(a, b) - p.distance(c, d);
+        }
+
+        template<class SOLUTION>
+        void apply(SOLUTION &s) const {
+            apply_updating_goal(*this, s, [&] { std::swap(s[i], s[(i + 1) % s.size()]); });
+        }
+
+        /// the swap is its own inverse
+        template<class SOLUTION>
+        void undo(SOLUTION &s) const { apply(s); }
+
+        /// the positions changed by apply(): {first, count}, wrapping around the tour
+        std::pair<int, int> affected(int /*n*/) const { return {i, 2}; }
+
+        template<class SOLUTION, class RGEN>
+        static swap_move random(const SOLUTION &s, RGEN &rgen) {
+            std::uniform_int_distribution<int> distr(0, s.size() - 1);
+            return {distr(rgen)};
+        }
+
+        /// visits every swap of s until visit returns false
+        template<class SOLUTION, class VISITOR>
+        static void for_each(const SOLUTION &s, VISITOR &&visit) {
+            const int n = s.size();
+            for (int i = 0; i < n; i++)
+                if (!visit(swap_move{i})) return;
+        }
+    };
+
+    /**
+     * 2-opt: removes the edges (i, i+1) and (j, j+1) for i < j, and reconnects the tour
+     * by reversing the path between them. The shorter of the two paths is reversed.
+     */
+    struct two_opt_move {
+        int i;
+        int j;
+
+        template<class SOLUTION>
+        double delta(const SOLUTION &s) const {
+            const int n = s.size();
+            auto &p = *s.problem;
+            int a = s[i];
+            int b = s[i + 1];
+            int c = s[j];
+            int d = s[(j + 1) % n];
+            return p.distance(a, c) + p.distance(b, d) - p.distance(a, b) - p.distance(c, d);
+        }
+
+        /// the same path is reversed again
+        template<class SOLUTION>
+        void undo(SOLUTION &s) const { apply(s); }
+
+        std::pair<int, int> affected(int n) const {
+            int count = j - i;
+            if (count * 2 > n) return {j + 1, n - count};
+            return {i + 1, count};
+        }
+
+        template<class SOLUTION>
+        void apply(SOLUTION &s) const {
+            apply_updating_goal(*this, s, [&] {
+                const int n = s.size();
+                auto [first, count] = affected(n);
+                for (int l = first, r = first + count - 1; l < r; l++, r--)
+                    std::swap(s[l % n], s[r % n]);
+            });
+        }
+
+        template<class SOLUTION, class RGEN>
+        static two_opt_move random(const SOLUTION &s, RGEN &rgen) {
+            const int n = s.size();
+            if (n < 4) return {0, 1};
+            std::uniform_int_distribution<int> distr_i(0, n - 1);
+            std::uniform_int_distribution<int> distr_j(0, n - 2);
+            int a = distr_i(rgen);
+            int b = distr_j(rgen);
+            if (b >= a) b++;
+            return {std::min(a, b), std::max(a, b)};
+        }
+
+        template<class SOLUTION, class VISITOR>
+        static void for_each(const SOLUTION &s, VISITOR &&visit) {
+            const int n = s.size();
+            for (int i = 0; i < n - 2; i++)
+                for (int j = i + 2; j < ((i == 0) ? n - 1 : n); j++)
+                    if (!visit(two_opt_move{i, j})) return;
+        }
+    };
+
+    /**
+     * Or-opt: moves the segment of len cities that starts at position i between
+     * the cities at positions j and j+1, optionally reversing it. The segment
+     * length is at most 3 for the neighbourhood and random moves.
+     */
+    struct or_opt_move {
+        int i;
+        int len;
+        int j;
+        bool reversed;
+
+        static constexpr int max_len = 3;
+
+        template<class SOLUTION>
+        double delta(const SOLUTION &s) const {
+            if (len < 1) return 0.0;
+            const int n = s.size();
+            auto &p = *s.problem;
+            int prev = s[(i + n - 1) % n];
+            int first = s[i];
+            int last = s[(i + len - 1) % n];
+            int next = s[(i + len) % n];
+            int c = s[j];
+            int e = s[(j + 1) % n];
+            double removed = p.distance(prev, next) - p.distance(prev, first) - p.distance(last, next);
+            double inserted = reversed ? p.distance(c, last) + p.distance(first, e)
+                                       : p.distance(c, first) + p.distance(last, e);
+            return removed + inserted - p.distance(c, e);
+        }
+
+        std::pair<int, int> affected(int n) const {
+            if (i + len > n) return {0, n};
+            if (j >= i + len) return {i, j + 1 - i};
+            return {j + 1, i + len - j - 1};
+        }
+
+        template<class SOLUTION>
+        void apply(SOLUTION &s) const {
+            if (len < 1) return;
+            apply_updating_goal(*this, s, [&] {
+                const int n = s.size();
+                int a = i;
+                int b = j;
+                if (a + len > n) {
+                    // the segment wraps around, so the tour is rotated to start with it
+                    std::rotate(s.begin(), s.begin() + a, s.end());
+                    b = (b - a + n) % n;
+                    a = 0;
+                }
+                auto first = s.begin() + a;
+                auto last = first + len;
+                if (b >= a + len) {
+                    std::rotate(first, last, s.begin() + b + 1);
+                    if (reversed) std::reverse(s.begin() + b + 1 - len, s.begin() + b + 1);
+                } else {
+                    std::rotate(s.begin() + b + 1, first, last);
+                    if (reversed) std::reverse(s.begin() + b + 1, s.begin() + b + 1 + len);
+                }
+            });
+        }
+
+        /// the insertion edge j must not touch the segment
+        static bool valid(int i, int len, int j, int n) {
+            return (j - i + 1 + n) % n > len;
+        }
+
+        template<class SOLUTION, class RGEN>
+        static or_opt_move random(const SOLUTION &s, RGEN &rgen) {
+            const int n = s.size();
+            if (n < 3) return {0, 0, 0, false};
+            std::uniform_int_distribution<int> distr_len(1, std::min(max_len, n - 2));
+            int len = distr_len(rgen);
+            std::uniform_int_distribution<int> distr_i(0, n - 1);
+            std::uniform_int_distribution<int> distr_j(0, n - len - 2);
+            std::uniform_int_distribution<int> distr_rev(0, (len > 1) ? 1 : 0);
+            int i = distr_i(rgen);
+            int j = (i + len + distr_j(rgen)) % n;
+            return {i, len, j, distr_rev(rgen) == 1};
+        }
+
+        template<class SOLUTION, class VISITOR>
+        static void for_each(const SOLUTION &s, VISITOR &&visit) {
+            const int n = s.size();
+            for (int len = 1; len <= std::min(max_len, n - 2); len++)
+                for (int i = 0; i < n; i++)
+                    for (int j = 0; j < n; j++) {
+                        if (!valid(i, len, j, n)) continue;
+                        if (!visit(or_opt_move{i, len, j, false})) return;
+                        if ((len > 1) && !visit(or_opt_move{i, len, j, true})) return;
+                    }
+        }
+    };
+
+} // mhe
+
+#endif //MHE_MOVES_H
@@ -0,0 +1,69 @@
+#ifndef MHE_NEIGHBOURHOOD_H
+#define MHE_NEIGHBOURHOOD_H
+
+#include "moves.h"
+#include "solution_t.h"
+
+#include <optional>
+#include <type_traits>
+#include <utility>
+
+namespace mhe {
+
+    template<class MOVE>
+    struct scored_move_t {
+        MOVE move;
+        double delta;
+    };
+
+    /**
+     * Lazy neighbourhood of the tour. Moves are enumerated on the tour itself, so no
+     * neighbour is materialized. The visitor can return bool - false stops the scan.
+     */
+    template<class MOVE = swap_move, class SOLUTION, class VISITOR>
+    void for_each_neighbour(const SOLUTION &s, VISITOR &&visit) {
+        MOVE::for_each(s, [&](const MOVE &m) {
+            if constexpr (std::is_void_v<std::invoke_result_t<VISITOR &, const MOVE &>>) {
+                visit(m);
+                return true;
+            } else {
+                return (bool) visit(m);
+            }
+        });
+    }
+
+    /**
+     * The move with the lowest delta among the allowed ones (the first one on ties).
+     * Every delta is computed exactly once. Empty if no move is allowed.
+     */
+    template<class MOVE = swap_move, class SOLUTION, class ALLOWED>
+    std::optional<scored_move_t<MOVE>> best_improvement(const SOLUTION &s, ALLOWED &&allowed) {
+        std::optional<scored_move_t<MOVE>> best;
+        for_each_neighbour<MOVE>(s, [&](const MOVE &m) {
+            if (!allowed(m)) return;
+            double delta = m.delta(s);
+            if (!best || delta < best->delta) best = scored_move_t<MOVE>{m, delta};
+        });
+        return best;
+    }
+
+    template<class MOVE = swap_move, class SOLUTION>
+    std::optional<scored_move_t<MOVE>> best_improvement(const SOLUTION &s) {
+        return best_improvement<MOVE>(s, [](const MOVE &) { return true; });
+    }
+
+    /// the first move that shortens the tour, or empty when s is a local optimum
+    template<class MOVE = swap_move, class SOLUTION>
+    std::optional<scored_move_t<MOVE>> first_improvement(const SOLUTION &s) {
+        std::optional<scored_move_t<MOVE>> found;
+        for_each_neighbour<MOVE>(s, [&](const MOVE &m) {
+            double delta = m.delta(s);
+            if (delta < 0) found = scored_move_t<MOVE>{m, delta};
+            return !found;
+        });
+        return found;
+    }
+
+} // mhe
+
+#endif //MHE_NEIGHBOURHOOD_H
@@ -0,0 +1,110 @@
+#ifndef MHE_POPULATION_ARENA_H
+#define MHE_POPULATION_ARENA_H
+
+#include "aligned_allocator.h"
+#include "solution_t.h"
+
+#include <cmath>
+#include <cstring>
+#include <limits>
+#include <optional>
+#include <span>
+#include <utility>
+#include <vector>
+
+namespace mhe {
+
+    /**
+     * One tour of population_arena_t. It has the part of the basic_solution_t interface
+     * that the moves use, so swap_move, two_opt_move and or_opt_move work on it directly,
+     * and the goal cache is the entry of the arena.
+     */
+    template<class CITY, class PROBLEM>
+    struct population_row_t {
+        basic_problem_handle_t<PROBLEM> problem;
+        CITY *cities;
+        int n;
+        double *goal_cache;
+
+        int size() const { return n; }
+        CITY &operator[](int i) const { return cities[i]; }
+        CITY *begin() const { return cities; }
+        CITY *end() const { return cities + n; }
+
+        std::optional<double> cached_goal() const {
+            if (std::isnan(*goal_cache)) return std::nullopt;
+            return *goal_cache;
+        }
+        void set_cached_goal(double value) { *goal_cache = value; }
+        void invalidate_goal() { *goal_cache = std::numeric_limits<double>::quiet_NaN(); }
+    };
+
+    /**
+     * The tours of the whole population in one aligned block, size x n cities, and their
+     * goals in a parallel array. Every row starts at a cache line. The operators write
+     * the offspring into the rows of the other arena, so there are no allocations after
+     * the start, and the generation is scanned in the memory order.
+     */
+    template<class CITY, class PROBLEM>
+    class population_arena_t {
+    public:
+        using row_t = population_row_t<CITY, PROBLEM>;
+
+        population_arena_t(basic_problem_handle_t<PROBLEM> problem_, int size_) :
+                problem(problem_), count(size_), n(problem_->size()), stride(padded_row(problem_->size())),
+                data(stride * size_), goals(size_, std::numeric_limits<double>::quiet_NaN()) {}
+
+        int size() const { return count; }
+
+        row_t row(int i) { return {problem, data.data() + i * stride, n, &goals[i]}; }
+
+        std::span<const CITY> cities(int i) const { return {data.data() + i * stride, std::size_t(n)}; }
+
+        /// copies the tour and its cached goal
+        template<class TOUR>
+        void assign(int i, const TOUR &tour, std::optional<double> goal) {
+            std::copy(tour.begin(), tour.end(), data.begin() + i * stride);
+            goals[i] = goal ? *goal : std::numeric_limits<double>::quiet_NaN();
+        }
+
+        void copy_row(int i, const population_arena_t &from, int j) {
+            std::memcpy(data.data() + i * stride, from.data.data() + j * stride, n * sizeof(CITY));
+            goals[i] = from.goals[j];
+        }
+
+        /// the cached goal, or the tour length computed as basic_solution_t::goal does
+        double goal(int i) {
+            if (!std::isnan(goals[i])) {
+                if (goal_statistics.enabled) goal_statistics.cached.fetch_add(1, std::memory_order_relaxed);
+                return goals[i];
+            }
+            if (goal_statistics.enabled) goal_statistics.evaluations.fetch_add(1, std::memory_order_relaxed);
+            goals[i] = tour_goal(*problem, data.data() + i * stride, n);
+            return goals[i];
+        }
+
+        void swap(population_arena_t &other) noexcept {
+            std::swap(count, other.count);
+            std::swap(stride, other.stride);
+            data.swap(other.data);
+            goals.swap(other.goals);
+        }
+
+    private:
+        /// the row length rounded up to the whole cache lines
+        static std::size_t padded_row(std::size_t cities) {
+            const std::size_t per_line = cache_line_size / sizeof(CITY);
+            return (cities + per_line - 1) / per_line * per_line;
+        }
+
+        basic_problem_handle_t<PROBLEM> problem;
+        int count;
+        int n;
+        std::size_t stride;
+        aligned_vector<CITY> data;
+        std::vector<double> goals;
+    };
+
+} // mhe
+
+#endif //MHE_POPULATION_ARENA_H
@@ -0,0 +1,310 @@
+#include "problem_file.h"
+#include "mapped_file.h"
+
+#include <array>
+#include <charconv>
+#include <cmath>
+#include <cstring>
+#include <memory>
+#include <stdexcept>
+#include <string_view>
+
+namespace mhe {
+
+    namespace {
+
+        constexpr auto powers_of_ten = [] {
+            std::array<double, 23> powers{};
+            powers[0] = 1.0;
+            for (int i = 1; i < powers.size(); i++) powers[i] = powers[i - 1] * 10.0;
+            return powers;
+        }();
+
+        /// more cities than in any known instance, a bigger count is a broken file
+        constexpr double max_cities = 100000000;
+
+        /**
+         * Reads the text without copying it. Everything below ' ' is a separator, so the
+         * inner loops are one comparison per character.
+         */
+        class scanner_t {
+        public:
+            scanner_t(const char *begin, const char *end_) : p(begin), end(end_) {}
+
+            explicit scanner_t(std::string_view text) : scanner_t(text.data(), text.data() + text.size()) {}
+
+            bool at_end() {
+                skip_spaces();
+                return p == end;
+            }
+
+            bool next_is_number() {
+                skip_spaces();
+                return (p != end) && (is_digit(*p) || *p == '-' || *p == '+' || *p == '.');
+            }
+
+            /// the next whitespace separated token
+            std::string_view word() {
+                skip_spaces();
+                const char *start = p;
+                while ((p != end) && !is_space(*p)) p++;
+                return {start, std::size_t(p - start)};
+            }
+
+            /// the rest of the current line
+            std::string_view line() {
+                const char *start = p;
+                auto eol = static_cast<const char *>(std::memchr(p, '\n', end - p));
+                p = eol ? eol : end;
+                return {start, std::size_t(p - start)};
+            }
+
+            /**
+             * Decimal number: [sign] digits [. digits] [e [sign] digits]. The digits are
+             * collected into an integer that is scaled once by an exact power of ten, so
+             * the result is correctly rounded. Only the numbers longer than that go
+             * through std::from_chars.
+             */
+            double number() {
+                if (at_end()) throw std::invalid_argument("unexpected end of file");
+                const char *start = p;
+                bool negative = false;
+                if ((p != end) && (*p == '-' || *p == '+')) negative = (*p++ == '-');
+                std::uint64_t mantissa = 0;
+                int digits = 0;
+                int exponent = 0;
+                bool any_digit = false;
+                for (; (p != end) && is_digit(*p); p++, any_digit = true) {
+                    if (digits < 19) {
+                        mantissa = mantissa * 10 + (*p - '0');
+                        digits += (mantissa != 0);
+                    } else {
+                        exponent++;
+                    }
+                }
+                if ((p != end) && (*p == '.')) {
+                    for (p++; (p != end) && is_digit(*p); p++, any_digit = true) {
+                        if (digits < 19) {
+                            mantissa = mantissa * 10 + (*p - '0');
+                            digits += (mantissa != 0);
+                            exponent--;
+                        }
+                    }
+                }
+                if (!any_digit) throw std::invalid_argument("number expected, found: " + std::string(word()));
+                if ((p != end) && (*p == 'e' || *p == 'E')) {
+                    p++;
+                    bool negative_exponent = false;
+                    if ((p != end) && (*p == '-' || *p == '+')) negative_exponent = (*p++ == '-');
+                    int e = 0;
+                    for (; (p != end) && is_digit(*p); p++) e = std::min(e * 10 + (*p - '0'), 100000);
+                    exponent += negative_exponent ? -e : e;
+                }
+                if ((mantissa < (std::uint64_t(1) << 53)) && (exponent >= -22) && (exponent <= 22)) {
+                    double value = (exponent < 0) ? mantissa / powers_of_ten[-exponent]
+                                                  : mantissa * powers_of_ten[exponent];
+                    return negative ? -value : value;
+                }
+                double value = 0;
+                if (*start == '+') start++;
+                auto [ptr, ec] = std::from_chars(start, p, value);
+                if ((ec != std::errc()) || (ptr != p))
+                    throw std::invalid_argument("number out of range: " + std::string(start, p));
+                return value;
+            }
+
+            /// the number of cities, a whole number from 1 to max_cities
+            std::size_t count(std::string_view what) {
+                skip_spaces();
+                const char *start = p;
+                double value = number();
+                if (!((value >= 1) && (value <= max_cities) && (value == std::floor(value))))
+                    throw std::invalid_argument("wrong " + std::string(what) + ": " + std::string(start, p));
+                return value;
+            }
+
+        private:
+            const char *p;
+            const char *end;
+
+            static bool is_space(char c) { return (unsigned char) c <= ' '; }
+
+            static bool is_digit(char c) { return (unsigned) (c - '0') < 10; }
+
+            void skip_spaces() {
+                while ((p != end) && is_space(*p)) p++;
+            }
+        };
+
+        std::string_view trim(std::string_view s) {
+            while (!s.empty() && (unsigned char) s.front() <= ' ') s.remove_prefix(1);
+            while (!s.empty() && (unsigned char) s.back() <= ' ') s.remove_suffix(1);
+            return s;
+        }
+
+        /// "id x y" lines, the ids are from 1 to dimension
+        void read_coordinates(scanner_t &in, problem_t &cities, std::size_t dimension) {
+            cities.assign(dimension, {0.0, 0.0});
+            for (std::size_t i = 0; i < dimension; i++) {
+                if (in.at_end()) throw std::invalid_argument("unexpected end of file after " + std::to_string(i) + " cities");
+                double id = in.number();
+                if ((id < 1) || (id > dimension)) throw std::invalid_argument("wrong node number: " + std::to_string(id));
+                double x = in.number();
+                double y = in.number();
+                cities[std::size_t(id) - 1] = {x, y};
+            }
+        }
+
+        /// the symmetric matrix written in one of the TSPLIB EDGE_WEIGHT_FORMAT layouts
+        void read_weights(scanner_t &in, std::vector<std::int32_t> &weights, std::size_t n, std::string_view format) {
+            weights.assign(n * n, 0);
+            auto read = [&](std::size_t a, std::size_t b) {
+                auto w = (std::int32_t) in.number();
+                weights[a * n + b] = w;
+                weights[b * n + a] = w;
+            };
+            if (format == "FULL_MATRIX") {
+                for (std::size_t a = 0; a < n; a++)
+                    for (std::size_t b = 0; b < n; b++) weights[a * n + b] = (std::int32_t) in.number();
+            } else if ((format == "UPPER_ROW") || (format == "LOWER_COL")) {
+                for (std::size_t a = 0; a < n; a++)
+                    for (std::size_t b = a + 1; b < n; b++) read(a, b);
+            } else if ((format == "LOWER_ROW") || (format == "UPPER_COL")) {
+                for (std::size_t a = 0; a < n; a++)
+                    for (std::size_t b = 0; b < a; b++) read(a, b);
+            } else if ((format == "UPPER_DIAG_ROW") || (format == "LOWER_DIAG_COL")) {
+                for (std::size_t a = 0; a < n; a++)
+                    for (std::size_t b = a; b < n; b++) read(a, b);
+            } else if ((format == "LOWER_DIAG_ROW") || (format == "UPPER_DIAG_COL")) {
+                for (std::size_t a = 0; a < n; a++)
+                    for (std::size_t b = 0; b <= a; b++) read(a, b);
+            } else {
+                throw std::invalid_argument("unsupported EDGE_WEIGHT_FORMAT: " + std::string(format));
+            }
+        }
+
+        problem_file_t read_tsplib(scanner_t &in) {
+            problem_file_t file;
+            std::size_t dimension = 0;
+            std::string edge_weight_format;
+            auto require_dimension = [&](std::string_view section) {
+                if (dimension == 0) throw std::invalid_argument("DIMENSION is missing before " + std::string(section));
+            };
+            while (!in.at_end()) {
+                auto line = in.line();
+                auto colon = line.find(':');
+                auto key = trim(line.substr(0, colon));
+                auto value = (colon == std::string_view::npos) ? std::string_view() : trim(line.substr(colon + 1));
+                if (key == "EOF") {
+                    break;
+                } else if ((key == "NODE_COORD_SECTION") || (key == "DISPLAY_DATA_SECTION")) {
+                    require_dimension(key);
+                    read_coordinates(in, file.cities, dimension);
+                } else if (key == "EDGE_WEIGHT_SECTION") {
+                    require_dimension(key);
+                    read_weights(in, file.weights, dimension, edge_weight_format);
+                } else if (key == "NAME") {
+                    file.name = value;
+                } else if (key == "TYPE") {
+                    if (value.substr(0, 3) != "TSP")
+                        throw std::invalid_argument("only symmetric TSP is supported, TYPE: " + std::string(value));
+                } else if (key == "DIMENSION") {
+                    dimension = scanner_t(value).count("DIMENSION");
+                } else if (key == "EDGE_WEIGHT_TYPE") {
+                    if (value == "EUC_2D") file.edge_weight_type = edge_weight_t::euc_2d;
+                    else if (value == "GEO") file.edge_weight_type = edge_weight_t::geo;
+                    else if (value == "ATT") file.edge_weight_type = edge_weight_t::att;
+                    else if (value == "EXPLICIT") file.edge_weight_type = edge_weight_t::explicit_matrix;
+                    else throw std::invalid_argument("unsupported EDGE_WEIGHT_TYPE: " + std::string(value));
+                } else if (key == "EDGE_WEIGHT_FORMAT") {
+                    edge_weight_format = value;
+                }
+                // COMMENT, NODE_COORD_TYPE, DISPLAY_DATA_TYPE etc. are not needed
+            }
+            if (file.edge_weight_type == edge_weight_t::explicit_matrix) {
+                if (file.weights.empty()) throw std::invalid_argument("EDGE_WEIGHT_SECTION is missing");
+                if (file.cities.empty()) file.cities.assign(dimension, {0.0, 0.0});
+            } else if (file.cities.empty()) {
+                throw std::invalid_argument("NODE_COORD_SECTION is missing");
+            }
+            return file;
+        }
+
+        /// the number of cities, then "name lat lon" for every city
+        problem_file_t read_text(scanner_t &in) {
+            problem_file_t file;
+            file.cities.resize(in.count("number of cities"));
+            for (std::size_t i = 0; i < file.cities.size(); i++) {
+                if (in.at_end()) throw std::invalid_argument("unexpected end of file after " + std::to_string(i) + " cities");
+                auto &city = file.cities[i];
+                in.word();
+                city[0] = in.number();
+                city[1] = in.number();
+            }
+            return file;
+        }
+
+        /// TSPLIB GEO: the coordinates are DDD.MM degrees and minutes, converted to radians
+        vec2d geo_radians(vec2d c) {
+            const double pi = 3.141592;
+            vec2d result;
+            for (int i = 0; i < 2; i++) {
+                double degrees = (int) c[i];
+                double minutes = c[i] - degrees;
+                result[i] = pi * (degrees + 5.0 * minutes / 3.0) / 180.0;
+            }
+            return result;
+        }
+
+        /// TSPLIB GEO: the distance in kilometers on the idealized sphere
+        std::int32_t geo_distance(vec2d a, vec2d b) {
+            const double rrr = 6378.388;
+            double q1 = std::cos(a[1] - b[1]);
+            double q2 = std::cos(a[0] - b[0]);
+            double q3 = std::cos(a[0] + b[0]);
+            return (std::int32_t) (rrr * std::acos(0.5 * ((1.0 + q1) * q2 - (1.0 - q1) * q3)) + 1.0);
+        }
+
+        /// TSPLIB ATT: the pseudo-euclidean distance, rounded up
+        std::int32_t att_distance(vec2d a, vec2d b) {
+            auto d = a - b;
+            double r = std::sqrt((d[0] * d[0] + d[1] * d[1]) / 10.0);
+            auto t = (std::int32_t) (r + 0.5);
+            return (t < r) ? t + 1 : t;
+        }
+    }
+
+    problem_file_t load_problem_file(const std::string &file_name) {
+        mapped_file_t mapped(file_name);
+        scanner_t in(mapped.begin(), mapped.end());
+        auto file = in.next_is_number() ? read_text(in) : read_tsplib(in);
+        if (file.name.empty()) file.name = file_name;
+        return file;
+    }
+
+    tsplib_problem_t tsplib_problem(const problem_file_t &file, std::size_t memory_limit) {
+        using distance_matrix_t = tsplib_problem_t::distance_matrix_t;
+        tsplib_problem_t problem(file.cities.begin(), file.cities.end());
+        const std::size_t n = problem.size();
+        if (file.edge_weight_type == edge_weight_t::euc_2d) return problem;
+        if (distance_matrix_t::bytes_for(n) > memory_limit)
+            throw std::invalid_argument("the distance matrix of " + file.name + " does not fit in memory");
+        if (file.edge_weight_type == edge_weight_t::geo) {
+            std::vector<vec2d> radians(n);
+            for (std::size_t i = 0; i < n; i++) radians[i] = geo_radians(file.cities[i]);
+            problem.distances = std::make_shared<const distance_matrix_t>(n, [&](int a, int b) {
+                return (a == b) ? 0 : geo_distance(radians[a], radians[b]);
+            });
+        } else if (file.edge_weight_type == edge_weight_t::att) {
+            problem.distances = std::make_shared<const distance_matrix_t>(n, [&](int a, int b) {
+                return att_distance(file.cities[a], file.cities[b]);
+            });
+        } else {
+            problem.distances = std::make_shared<const distance_matrix_t>(n, [&](int a, int b) {
+                return file.weights[a * n + b];
+            });
+        }
+        return problem;
+    }
+
+} // mhe
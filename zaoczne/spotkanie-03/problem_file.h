@@ -0,0 +1,47 @@
+#ifndef MHE_PROBLEM_FILE_H
+#define MHE_PROBLEM_FILE_H
+
+#include "problem_t.h"
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace mhe {
+
+    /// the TSPLIB EDGE_WEIGHT_TYPE values that can be read
+    enum class edge_weight_t {
+        euc_2d, geo, att, explicit_matrix
+    };
+
+    /// the instance read by load_problem_file
+    struct problem_file_t {
+        std::string name;
+        edge_weight_t edge_weight_type = edge_weight_t::euc_2d;
+        /// the coordinates; for EXPLICIT instances the DISPLAY_DATA_SECTION, or zeros
+        problem_t cities;
+        /// the full n x n matrix of EXPLICIT instances, empty otherwise
+        std::vector<std::int32_t> weights;
+    };
+
+    /**
+     * Reads the instance from a memory mapped file. The format is detected from the content:
+     * - TSPLIB .tsp: symmetric TSP with NODE_COORD_SECTION (EUC_2D, GEO, ATT) or
+     *   EDGE_WEIGHT_SECTION (EXPLICIT, any of the FULL_MATRIX, ROW and COL formats),
+     * - text: the number of cities, then one "name lat lon" line for every city.
+     *   The names are skipped, the coordinates are euclidean.
+     * Throws std::invalid_argument if the file cannot be read.
+     */
+    problem_file_t load_problem_file(const std::string &file_name);
+
+    /**
+     * The problem with the integer TSPLIB distances of the instance. EUC_2D distances are
+     * computed from the coordinates; the other types need the distance matrix, so it is
+     * built here and std::invalid_argument is thrown if it would exceed memory_limit.
+     */
+    tsplib_problem_t tsplib_problem(const problem_file_t &file,
+                                    std::size_t memory_limit = tsplib_problem_t::default_distance_cache_limit);
+
+} // mhe
+
+#endif //MHE_PROBLEM_FILE_H
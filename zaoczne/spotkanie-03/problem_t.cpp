@@ -1,33 +1,113 @@
-//
-// Created by pantadeusz on 3/25/2023.
-//
-
-#include "problem_t.h"
-
-#include "vec2d.h"
-
-#include <vector>
-#include <iostream>
-
-
-namespace mhe {
-
-    problem_t generate_problem(int size, double w, double h, std::mt19937 &rgen) {
-        std::uniform_real_distribution<double> w_distr(0.0, w);
-        std::uniform_real_distribution<double> h_distr(0.0, h);
-        problem_t problem;
-        for (int i = 0; i < size; i++) {
-            problem.push_back({w_distr(rgen), h_distr(rgen)});
-        }
-        return problem;
-    }
-
-    std::ostream &operator<<(std::ostream &o, const problem_t v) {
-        o << "{ ";
-        for (auto e: v)
-            o << e << " ";
-        o << "}";
-        return o;
-    }
-}
-
+//
+// Created by pantadeusz on 3/25/2023.
+//
+
+#include "problem_t.h"
+
+#include "kd_tree.h"
+#include "vec2d.h"
+
+#include <algorithm>
+#include <deque>
+#include <mutex>
+#include <vector>
+#include <iostream>
+
+
+namespace mhe {
+
+    template<class METRIC>
+    basic_distance_matrix_t<METRIC>::basic_distance_matrix_t(const std::vector<vec2d> &cities) :
+            stride(padded_row(cities.size())), data(stride * cities.size(), 0) {
+        const int n = cities.size();
+        for (int a = 0; a < n; a++) {
+            for (int b = a + 1; b < n; b++) {
+                distance_type d = METRIC::distance(cities[a], cities[b]);
+                data[a * stride + b] = d;
+                data[b * stride + a] = d;
+            }
+        }
+    }
+
+    template<class METRIC>
+    std::size_t basic_distance_matrix_t<METRIC>::bytes_for(std::size_t cities) {
+        return padded_row(cities) * cities * sizeof(distance_type);
+    }
+
+    template<class METRIC>
+    bool basic_problem_t<METRIC>::precompute_distances(std::size_t memory_limit) {
+        if (distance_matrix_t::bytes_for(size()) > memory_limit) {
+            distances.reset();
+            return false;
+        }
+        distances = std::make_shared<const distance_matrix_t>(*this);
+        return true;
+    }
+
+    candidate_lists_t::candidate_lists_t(const std::vector<vec2d> &cities, int k_) {
+        const int n = cities.size();
+        k = std::max(0, std::min(k_, n - 1));
+        data.resize(n * k);
+        kd_tree_t tree(cities);
+        std::vector<int> nearest;
+        // the queries for the neighbouring cities go through the same part of the tree
+        for (int a: tree.spatial_order()) {
+            tree.k_nearest(cities[a], k, a, nearest);
+            std::copy(nearest.begin(), nearest.end(), data.begin() + a * k);
+        }
+    }
+
+    template<class METRIC>
+    void basic_problem_t<METRIC>::precompute_candidates(int k) {
+        candidates = nearest_candidates(k);
+    }
+
+    template<class METRIC>
+    std::shared_ptr<const candidate_lists_t> basic_problem_t<METRIC>::nearest_candidates(int k) const {
+        if (distances)
+            return std::make_shared<const candidate_lists_t>(size(), k, [this](int a, int b) { return distance(a, b); });
+        return std::make_shared<const candidate_lists_t>(*this, k);
+    }
+
+    template<class METRIC>
+    void basic_problem_t<METRIC>::precompute_coordinates() {
+        coordinates = std::make_shared<const coordinates_soa_t<double>>(*this);
+    }
+
+    template<class PROBLEM>
+    basic_problem_handle_t<PROBLEM> register_problem(PROBLEM problem) {
+        // deque does not move the elements when it grows, so the handles stay valid
+        static std::deque<PROBLEM> registered_problems;
+        static std::mutex registry_mutex;
+        std::lock_guard<std::mutex> lock(registry_mutex);
+        registered_problems.push_back(std::move(problem));
+        return basic_problem_handle_t<PROBLEM>(&registered_problems.back());
+    }
+
+    template class basic_distance_matrix_t<euclidean_metric>;
+    template class basic_distance_matrix_t<tsplib_euc2d_metric>;
+    template class basic_problem_t<euclidean_metric>;
+    template class basic_problem_t<tsplib_euc2d_metric>;
+
+    template problem_handle_t register_problem(problem_t);
+    template tsplib_problem_handle_t register_problem(tsplib_problem_t);
+
+    problem_t generate_problem(int size, double w, double h, std::mt19937 &rgen) {
+        std::uniform_real_distribution<double> w_distr(0.0, w);
+        std::uniform_real_distribution<double> h_distr(0.0, h);
+        problem_t problem;
+        for (int i = 0; i < size; i++) {
+            problem.push_back({w_distr(rgen), h_distr(rgen)});
+        }
+        return problem;
+    }
+
+    std::ostream &operator<<(std::ostream &o, const problem_t v) {
+        o << "{ ";
+        for (auto e: v)
+            o << e << " ";
+        o << "}";
+        return o;
+    }
+}
+
@@ -1,21 +1,215 @@
-//
-// Created by pantadeusz on 3/25/2023.
-//
-
-#ifndef MHE_PROBLEM_T_H
-#define MHE_PROBLEM_T_H
-
-#include "vec2d.h"
-
-#include <vector>
-#include <iostream>
-#include <random>
-namespace mhe {
-    using problem_t = std::vector<vec2d>;
-
-    problem_t generate_problem(int size, double w, double h, std::mt19937 &rgen);
-
-    std::ostream &operator<<(std::ostream &o, const problem_t v);
-}
-
-#endif //MHE_PROBLEM_T_H
+//
+// Created by pantadeusz on 3/25/2023.
+//
+
+#ifndef MHE_PROBLEM_T_H
+#define MHE_PROBLEM_T_H
+
+#include "aligned_allocator.h"
+#include "tour_length.h"
+#include "vec2d.h"
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+#include <iostream>
+#include <memory>
+#include <random>
+namespace mhe {
+
+    /// the euclidean distance in double precision
+    struct euclidean_metric {
+        using distance_type = double;
+
+        static distance_type distance(vec2d a, vec2d b) { return len(a - b); }
+    };
+
+    /**
+     * TSPLIB EUC_2D: the euclidean distance rounded to the nearest integer, nint(sqrt(...)).
+     * Tour lengths are sums of integers, so they are exact and can be compared
+     * with the published optimal tour lengths.
+     */
+    struct tsplib_euc2d_metric {
+        using distance_type = std::int32_t;
+
+        static distance_type distance(vec2d a, vec2d b) { return (distance_type) (len(a - b) + 0.5); }
+    };
+
+    /**
+     * The n x n matrix of distances between cities, stored in one contiguous block.
+     * Every row is padded to the full cache line, so rows never share a line.
+     */
+    template<class METRIC>
+    class basic_distance_matrix_t {
+    public:
+        using distance_type = typename METRIC::distance_type;
+
+        explicit basic_distance_matrix_t(const std::vector<vec2d> &cities);
+
+        /// the matrix of n cities with the distances given by dist(a, b), e.g. read from a file
+        template<class DIST>
+        basic_distance_matrix_t(std::size_t n, DIST &&dist) : stride(padded_row(n)), data(stride * n, 0) {
+            for (std::size_t a = 0; a < n; a++)
+                for (std::size_t b = 0; b < n; b++)
+                    data[a * stride + b] = dist(a, b);
+        }
+
+        distance_type operator()(int a, int b) const { return data[a * stride + b]; }
+        const distance_type *row(int a) const { return data.data() + a * stride; }
+
+        /// memory needed by the matrix for the given number of cities
+        static std::size_t bytes_for(std::size_t cities);
+
+    private:
+        /// the row length rounded up to the whole cache lines
+        static std::size_t padded_row(std::size_t cities) {
+            const std::size_t per_line = cache_line_size / sizeof(distance_type);
+            return (cities + per_line - 1) / per_line * per_line;
+        }
+
+        std::size_t stride;
+        aligned_vector<distance_type> data;
+    };
+
+    using distance_matrix_t = basic_distance_matrix_t<euclidean_metric>;
+
+    /**
+     * For every city the k nearest other cities, sorted by distance. Local search
+     * considers only the moves that connect a city with one of its candidates.
+     */
+    class candidate_lists_t {
+    public:
+        /// euclidean nearest neighbours, found with kd_tree_t in O(n k log n)
+        candidate_lists_t(const std::vector<vec2d> &cities, int k);
+
+        /// the lists of n cities, ranked by dist(a, b); it checks all the pairs
+        template<class DIST>
+        candidate_lists_t(std::size_t n, int k_, DIST &&dist) {
+            k = std::max(0, std::min(k_, (int) n - 1));
+            data.resize(n * k);
+            std::vector<std::pair<double, int>> others;
+            for (int a = 0; a < n; a++) {
+                others.clear();
+                for (int b = 0; b < n; b++)
+                    if (b != a) others.push_back({dist(a, b), b});
+                std::partial_sort(others.begin(), others.begin() + k, others.end());
+                for (int i = 0; i < k; i++) data[a * k + i] = others[i].second;
+            }
+        }
+
+        int k;
+
+        const int *begin(int city) const { return data.data() + city * k; }
+        const int *end(int city) const { return data.data() + (city + 1) * k; }
+
+    private:
+        std::vector<int> data;
+    };
+
+    /**
+     * The cities of the problem. METRIC selects how the distances are computed, at
+     * compile time: problem_t uses double precision, tsplib_problem_t the rounded
+     * integer TSPLIB distances.
+     */
+    template<class METRIC>
+    class basic_problem_t : public std::vector<vec2d> {
+    public:
+        using std::vector<vec2d>::vector;
+        using metric_t = METRIC;
+        using distance_type = typename METRIC::distance_type;
+        using distance_matrix_t = basic_distance_matrix_t<METRIC>;
+
+        /// the matrix is not built when it would take more memory than this
+        static constexpr std::size_t default_distance_cache_limit = 256 * 1024 * 1024;
+
+        /// shared between copies of the problem; empty when distances are computed on the fly
+        std::shared_ptr<const distance_matrix_t> distances;
+
+        /**
+         * Precompute the distance matrix. It must be called after the cities are set,
+         * and it falls back to on-the-fly distances if the matrix would exceed memory_limit.
+         * @return true if the matrix is available
+         */
+        bool precompute_distances(std::size_t memory_limit = default_distance_cache_limit);
+
+        /// the nearest neighbours lists, shared between copies of the problem
+        std::shared_ptr<const candidate_lists_t> candidates;
+
+        void precompute_candidates(int k);
+
+        /**
+         * The k nearest cities lists. When there is the distance matrix, they are ranked
+         * by it, so they follow any metric. Otherwise they come from the spatial index.
+         */
+        std::shared_ptr<const candidate_lists_t> nearest_candidates(int k) const;
+
+        /// structure of arrays copy of the cities, used by the SIMD goal when there is no matrix
+        std::shared_ptr<const coordinates_soa_t<double>> coordinates;
+
+        void precompute_coordinates();
+
+        distance_type distance(int a, int b) const {
+            if (distances) return (*distances)(a, b);
+            return METRIC::distance((*this)[a], (*this)[b]);
+        }
+    };
+
+    using problem_t = basic_problem_t<euclidean_metric>;
+
+    using tsplib_problem_t = basic_problem_t<tsplib_euc2d_metric>;
+
+    extern template class basic_distance_matrix_t<euclidean_metric>;
+    extern template class basic_distance_matrix_t<tsplib_euc2d_metric>;
+    extern template class basic_problem_t<euclidean_metric>;
+    extern template class basic_problem_t<tsplib_euc2d_metric>;
+
+    template<class PROBLEM>
+    class basic_problem_handle_t;
+
+    template<class PROBLEM>
+    basic_problem_handle_t<PROBLEM> register_problem(PROBLEM problem);
+
+    /**
+     * Cheap, non-owning reference to a problem registered with register_problem().
+     * Registered problems are immutable and live until the end of the program, so
+     * copying a solution copies only the permutation and one pointer.
+     */
+    template<class PROBLEM>
+    class basic_problem_handle_t {
+    public:
+        basic_problem_handle_t() = default;
+
+        const PROBLEM &operator*() const { return *problem; }
+        const PROBLEM *operator->() const { return problem; }
+        explicit operator bool() const { return problem != nullptr; }
+        bool operator==(const basic_problem_handle_t &) const = default;
+
+    private:
+        explicit basic_problem_handle_t(const PROBLEM *problem_) : problem(problem_) {}
+
+        const PROBLEM *problem = nullptr;
+
+        friend basic_problem_handle_t register_problem<PROBLEM>(PROBLEM problem);
+    };
+
+    using problem_handle_t = basic_problem_handle_t<problem_t>;
+
+    using tsplib_problem_handle_t = basic_problem_handle_t<tsplib_problem_t>;
+
+    /**
+     * Stores the problem in the global registry. The distance matrix, candidate lists etc.
+     * must be precomputed before, because the registered problem cannot be modified.
+     */
+    template<class PROBLEM>
+    basic_problem_handle_t<PROBLEM> register_problem(PROBLEM problem);
+
+    extern template problem_handle_t register_problem(problem_t);
+    extern template tsplib_problem_handle_t register_problem(tsplib_problem_t);
+
+    problem_t generate_problem(int size, double w, double h, std::mt19937 &rgen);
+
+    std::ostream &operator<<(std::ostream &o, const problem_t v);
+}
+
+#endif //MHE_PROBLEM_T_H
@@ -1,87 +1,97 @@
-//
-// Created by pantadeusz on 3/25/2023.
-//
-
-#include "solution_t.h"
-
-namespace mhe {
-
-    solution_t solution_t::for_problem(std::shared_ptr<problem_t> problem_) {
-        solution_t sol;
-        sol.resize(problem_->size());
-        std::generate(sol.begin(), sol.end(), [n = 0]() mutable { return n++; });
-        sol.problem = problem_;
-        return sol;
-    }
-
-    solution_t solution_t::random_solution(problem_t tsp_problem, std::mt19937 &rgen) {
-
-        auto solution = solution_t::for_problem(make_shared<problem_t>(tsp_problem));
-        std::shuffle(solution.begin(), solution.end(), rgen);
-        return solution;
-    }
-
-    double solution_t::goal() const {
-        double sum_distance = 0;
-        for (int i = 0; i < size(); i++) {
-            auto &p = *problem;
-            auto &t = *this;
-            sum_distance += len(p[t[i]] - p[t[(i + 1) % size()]]);
-        }
-        return sum_distance;
-    }
-
-    solution_t solution_t::start_from_zero() const {
-        solution_t ret = *this;
-        for (int i = 1; i < size(); i++) {
-            if (at(i) == 0) {
-                for (int j = 0; j < size(); j++) {
-                    ret[j] = at((i + j) % size());
-                }
-                break;
-            }
-        }
-        return ret;
-    }
-
-    solution_t solution_t::random_modify(std::mt19937 &rgen) const {
-        using namespace std;
-        solution_t current_point = *this;
-        uniform_int_distribution<int> distr(0, size() - 1);
-        int a = distr(rgen);
-        std::swap(current_point[a], current_point[(a + 1) % current_point.size()]);
-        return current_point;
-    }
-
-    std::vector<solution_t> solution_t::generate_neighbours() const {
-        auto current_point = *this;
-        std::vector<solution_t> result;
-        for (int i = 0; i < current_point.size(); i++) {
-            solution_t neighbour = current_point;
-            std::swap(neighbour[i], neighbour[(i + 1) % current_point.size()]);
-            result.push_back(neighbour);
-        }
-        return result;
-    }
-
-
-    solution_t solution_t::best_neighbour() const {
-        auto current_point = *this;
-        using namespace std;
-        std::vector<solution_t> neighbours = current_point.generate_neighbours();
-        return *std::max_element(neighbours.begin(), neighbours.end(), [](auto l, auto r) {
-            return l.goal() > r.goal();
-        });
-    }
-
-
-    std::ostream &operator<<(std::ostream &o, const solution_t v) {
-        o << "{ ";
-        for (auto e: v)
-            o << e << " ";
-        o << "}";
-        return o;
-    }
-
-
-} // mhe
\ No newline at end of file
+//
+// Created by pantadeusz on 3/25/2023.
+//
+
+#include "solution_t.h"
+#include "moves.h"
+#include "neighbourhood.h"
+
+#include <stdexcept>
+
+namespace mhe {
+
+    template<class CITY, class STORAGE, class PROBLEM>
+    basic_solution_t<CITY, STORAGE, PROBLEM> basic_solution_t<CITY, STORAGE, PROBLEM>::for_problem(basic_problem_handle_t<PROBLEM> problem_) {
+        if (problem_->size() > max_cities())
+            throw std::invalid_argument("too many cities for the tour index type: " + std::to_string(problem_->size()));
+        basic_solution_t sol;
+        sol.resize(problem_->size());
+        std::generate(sol.begin(), sol.end(), [n = 0]() mutable { return n++; });
+        sol.problem = problem_;
+        return sol;
+    }
+
+    template<class CITY, class STORAGE, class PROBLEM>
+    basic_solution_t<CITY, STORAGE, PROBLEM> basic_solution_t<CITY, STORAGE, PROBLEM>::random_solution(basic_problem_handle_t<PROBLEM> tsp_problem, std::mt19937 &rgen) {
+        auto solution = basic_solution_t::for_problem(tsp_problem);
+        std::shuffle(solution.begin(), solution.end(), rgen);
+        return solution;
+    }
+
+    goal_statistics_t goal_statistics;
+
+    template<class CITY, class STORAGE, class PROBLEM>
+    double basic_solution_t<CITY, STORAGE, PROBLEM>::goal() const {
+        if (!std::isnan(goal_cache)) {
+            if (goal_statistics.enabled) goal_statistics.cached.fetch_add(1, std::memory_order_relaxed);
+            return goal_cache;
+        }
+        if (goal_statistics.enabled) goal_statistics.evaluations.fetch_add(1, std::memory_order_relaxed);
+        goal_cache = evaluate_goal();
+        return goal_cache;
+    }
+
+    template<class CITY, class STORAGE, class PROBLEM>
+    double basic_solution_t<CITY, STORAGE, PROBLEM>::evaluate_goal() const {
+        return tour_goal(*problem, data(), this->size());
+    }
+
+    template<class CITY, class STORAGE, class PROBLEM>
+    basic_solution_t<CITY, STORAGE, PROBLEM> basic_solution_t<CITY, STORAGE, PROBLEM>::start_from_zero() const {
+        basic_solution_t ret = *this;
+        const int n = this->size();
+        for (int i = 1; i < n; i++) {
+            if (at(i) == 0) {
+                for (int j = 0; j < n; j++) {
+                    ret[j] = at((i + j) % n);
+                }
+                break;
+            }
+        }
+        return ret;
+    }
+
+    template<class CITY, class STORAGE, class PROBLEM>
+    basic_solution_t<CITY, STORAGE, PROBLEM> basic_solution_t<CITY, STORAGE, PROBLEM>::random_modify(std::mt19937 &rgen) const {
+        basic_solution_t current_point = *this;
+        swap_move::random(current_point, rgen).apply(current_point);
+        return current_point;
+    }
+
+    template<class CITY, class STORAGE, class PROBLEM>
+    std::vector<basic_solution_t<CITY, STORAGE, PROBLEM>> basic_solution_t<CITY, STORAGE, PROBLEM>::generate_neighbours() const {
+        auto current_point = *this;
+        std::vector<basic_solution_t> result;
+        for (int i = 0; i < current_point.size(); i++) {
+            basic_solution_t neighbour = current_point;
+            swap_move{i}.apply(neighbour);
+            result.push_back(neighbour);
+        }
+        return result;
+    }
+
+
+    template<class CITY, class STORAGE, class PROBLEM>
+    basic_solution_t<CITY, STORAGE, PROBLEM> basic_solution_t<CITY, STORAGE, PROBLEM>::best_neighbour() const {
+        auto current_point = *this;
+        if (auto best = best_improvement(current_point)) best->move.apply(current_point);
+        return current_point;
+    }
+
+    template class basic_solution_t<int>;
+    template class basic_solution_t<std::uint16_t>;
+    template class basic_solution_t<std::uint32_t>;
+    template class basic_solution_t<std::uint8_t, static_vector<std::uint8_t, inline_solution_capacity>>;
+    template class basic_solution_t<int, std::vector<int>, tsplib_problem_t>;
+
+} // mhe
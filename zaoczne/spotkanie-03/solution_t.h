@@ -1,46 +1,255 @@
-//
-// Created by pantadeusz on 3/25/2023.
-//
-
-#ifndef MHE_SOLUTION_T_H
-#define MHE_SOLUTION_T_H
-
-#include "problem_t.h"
-
-#include <iostream>
-#include <algorithm>
-#include <array>
-#include <memory>
-#include <numeric>
-#include <random>
-#include <string>
-#include <vector>
-#include <iomanip>
-#include <list>
-#include <set>
-
-
-namespace mhe {
-
-    class solution_t : public std::vector<int> {
-    public:
-        std::shared_ptr<problem_t> problem;
-
-        static solution_t for_problem(std::shared_ptr<problem_t> problem_) ;
-        double goal() const ;
-        solution_t start_from_zero() const ;
-        solution_t random_modify(std::mt19937 &rgen) const ;
-        std::vector<solution_t> generate_neighbours() const ;
-        solution_t best_neighbour() const ;
-
-        static solution_t random_solution(problem_t tsp_problem, std::mt19937 &rgen) ;
-    };
-
-
-
-    std::ostream &operator<<(std::ostream &o, const solution_t v);
-
-
-} // mhe
-
-#endif //MHE_SOLUTION_T_H
+//
+// Created by pantadeusz on 3/25/2023.
+//
+
+#ifndef MHE_SOLUTION_T_H
+#define MHE_SOLUTION_T_H
+
+#include "problem_t.h"
+#include "static_vector.h"
+
+#include <iostream>
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <cmath>
+#include <cstdint>
+#include <limits>
+#include <memory>
+#include <numeric>
+#include <optional>
+#include <random>
+#include <string>
+#include <vector>
+#include <iomanip>
+#include <list>
+#include <set>
+#include <type_traits>
+
+
+namespace mhe {
+
+    /**
+     * Counters of goal() calls, to see how many full evaluations the cache saves. They are
+     * shared by all the threads, so they are counted only when enabled is set before the
+     * run, otherwise goal() does not write to them.
+     */
+    struct goal_statistics_t {
+        bool enabled = false; ///< count the calls, for -print_evaluations
+        std::atomic<long> evaluations{0}; ///< full O(n) evaluations of the tour
+        std::atomic<long> cached{0}; ///< calls answered from the cache
+    };
+
+    extern goal_statistics_t goal_statistics;
+
+    /**
+     * Length of the closed tour of n cities, accumulated in SUM. The closing edge is
+     * added outside of the loop, so there is no modulo in the hot path.
+     */
+    template<class SUM, class CITY, class DIST>
+    SUM closed_tour_length(const CITY *t, int n, DIST dist) {
+        if (n == 0) return 0;
+        SUM sum_distance = 0;
+        for (int i = 0; i < n - 1; i++) {
+            sum_distance += dist(t[i], t[i + 1]);
+        }
+        return sum_distance + dist(t[n - 1], t[0]);
+    }
+
+    /**
+     * The goal of the tour of n cities: from the distance matrix if there is one, from
+     * the SIMD kernel over the coordinates for the Euclidean int tours, and from the
+     * metric otherwise. Integer distances are summed exactly, the sum fits in double
+     * without rounding. Used by basic_solution_t and population_arena_t.
+     */
+    template<class CITY, class PROBLEM>
+    double tour_goal(const PROBLEM &p, const CITY *t, int n) {
+        using sum_type = std::conditional_t<std::is_integral_v<typename PROBLEM::distance_type>, std::int64_t, double>;
+        using metric_t = typename PROBLEM::metric_t;
+        if (p.distances) {
+            auto &d = *p.distances;
+            return closed_tour_length<sum_type>(t, n, [&d](int a, int b) { return d(a, b); });
+        }
+        if constexpr (std::is_same_v<CITY, int> && std::is_same_v<metric_t, euclidean_metric>) {
+            if (p.coordinates) return tour_length(*p.coordinates, t, n);
+        }
+        return closed_tour_length<sum_type>(t, n, [&p](int a, int b) { return metric_t::distance(p[a], p[b]); });
+    }
+
+    /**
+     * The tour, stored as a permutation of CITY indices in STORAGE. The narrower the
+     * CITY type, the smaller the population; solution_t is the default int version.
+     * PROBLEM selects the distance metric, see basic_problem_t.
+     *
+     * The value of goal() is cached until the tour is modified. Every non-const
+     * access to the elements (operator[], iterators, data(), modifiers) drops the
+     * cache, and moves update it with their delta instead.
+     */
+    template<class CITY, class STORAGE = std::vector<CITY>, class PROBLEM = problem_t>
+    class basic_solution_t : public STORAGE {
+    public:
+        using city_t = CITY;
+        using problem_type = PROBLEM;
+        using distance_type = typename PROBLEM::distance_type;
+        using typename STORAGE::size_type;
+        using typename STORAGE::reference;
+        using typename STORAGE::iterator;
+        using typename STORAGE::reverse_iterator;
+
+        basic_problem_handle_t<PROBLEM> problem;
+
+        static basic_solution_t for_problem(basic_problem_handle_t<PROBLEM> problem_) ;
+        double goal() const ;
+        std::optional<double> cached_goal() const {
+            if (std::isnan(goal_cache)) return std::nullopt;
+            return goal_cache;
+        }
+        void set_cached_goal(double value) { goal_cache = value; }
+        void invalidate_goal() { goal_cache = std::numeric_limits<double>::quiet_NaN(); }
+        basic_solution_t start_from_zero() const ;
+        basic_solution_t random_modify(std::mt19937 &rgen) const ;
+        std::vector<basic_solution_t> generate_neighbours() const ;
+        basic_solution_t best_neighbour() const ;
+
+        static basic_solution_t random_solution(basic_problem_handle_t<PROBLEM> tsp_problem, std::mt19937 &rgen) ;
+
+        /// the largest number of cities that the CITY type can index
+        static constexpr std::size_t max_cities() {
+            return std::size_t(std::numeric_limits<CITY>::max()) + 1;
+        }
+
+        using STORAGE::operator[];
+        using STORAGE::at;
+        using STORAGE::begin;
+        using STORAGE::end;
+        using STORAGE::rbegin;
+        using STORAGE::rend;
+        using STORAGE::data;
+        using STORAGE::front;
+        using STORAGE::back;
+
+        reference operator[](size_type i) {
+            invalidate_goal();
+            return STORAGE::operator[](i);
+        }
+
+        reference at(size_type i) {
+            invalidate_goal();
+            return STORAGE::at(i);
+        }
+
+        iterator begin() {
+            invalidate_goal();
+            return STORAGE::begin();
+        }
+
+        iterator end() {
+            invalidate_goal();
+            return STORAGE::end();
+        }
+
+        reverse_iterator rbegin() {
+            invalidate_goal();
+            return STORAGE::rbegin();
+        }
+
+        reverse_iterator rend() {
+            invalidate_goal();
+            return STORAGE::rend();
+        }
+
+        CITY *data() {
+            invalidate_goal();
+            return STORAGE::data();
+        }
+
+        reference front() {
+            invalidate_goal();
+            return STORAGE::front();
+        }
+
+        reference back() {
+            invalidate_goal();
+            return STORAGE::back();
+        }
+
+        template<class... ARGS>
+        void resize(ARGS &&... args) {
+            invalidate_goal();
+            STORAGE::resize(std::forward<ARGS>(args)...);
+        }
+
+        template<class... ARGS>
+        void assign(ARGS &&... args) {
+            invalidate_goal();
+            STORAGE::assign(std::forward<ARGS>(args)...);
+        }
+
+        template<class... ARGS>
+        auto insert(ARGS &&... args) {
+            invalidate_goal();
+            return STORAGE::insert(std::forward<ARGS>(args)...);
+        }
+
+        template<class... ARGS>
+        auto erase(ARGS &&... args) {
+            invalidate_goal();
+            return STORAGE::erase(std::forward<ARGS>(args)...);
+        }
+
+        void push_back(CITY city) {
+            invalidate_goal();
+            STORAGE::push_back(city);
+        }
+
+        void pop_back() {
+            invalidate_goal();
+            STORAGE::pop_back();
+        }
+
+        void clear() {
+            invalidate_goal();
+            STORAGE::clear();
+        }
+
+    private:
+        /// NaN when the goal is not known
+        mutable double goal_cache = std::numeric_limits<double>::quiet_NaN();
+
+        double evaluate_goal() const ;
+    };
+
+    using solution_t = basic_solution_t<int>;
+
+    /// tours for up to 65536 cities, half of the memory of solution_t
+    using solution16_t = basic_solution_t<std::uint16_t>;
+
+    using solution32_t = basic_solution_t<std::uint32_t>;
+
+    /// capacity of the tour that is stored inside of the solution object
+    constexpr std::size_t inline_solution_capacity = 64;
+
+    /// tours of tiny instances, without any heap allocation
+    using inline_solution_t = basic_solution_t<std::uint8_t, static_vector<std::uint8_t, inline_solution_capacity>>;
+
+    /// tour with the TSPLIB integer distances, its goal() is an exact integer
+    using tsplib_solution_t = basic_solution_t<int, std::vector<int>, tsplib_problem_t>;
+
+    template<class CITY, class STORAGE, class PROBLEM>
+    std::ostream &operator<<(std::ostream &o, const basic_solution_t<CITY, STORAGE, PROBLEM> &v) {
+        o << "{ ";
+        for (auto e: v)
+            o << (int) e << " ";
+        o << "}";
+        return o;
+    }
+
+    extern template class basic_solution_t<int>;
+    extern template class basic_solution_t<std::uint16_t>;
+    extern template class basic_solution_t<std::uint32_t>;
+    extern template class basic_solution_t<std::uint8_t, static_vector<std::uint8_t, inline_solution_capacity>>;
+    extern template class basic_solution_t<int, std::vector<int>, tsplib_problem_t>;
+
+} // mhe
+
+#endif //MHE_SOLUTION_T_H
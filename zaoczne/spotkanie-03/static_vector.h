@@ -0,0 +1,122 @@
+#ifndef MHE_STATIC_VECTOR_H
+#define MHE_STATIC_VECTOR_H
+
+#include <algorithm>
+#include <array>
+#include <compare>
+#include <cstddef>
+#include <cstdint>
+#include <iterator>
+#include <stdexcept>
+
+namespace mhe {
+
+    /**
+     * Vector with the elements stored inline, up to CAPACITY of them. It has the part
+     * of the std::vector interface that is used by the solutions, so a tour of a small
+     * instance needs no heap allocation.
+     */
+    template<class T, std::size_t CAPACITY>
+    class static_vector {
+    public:
+        using value_type = T;
+        using size_type = std::size_t;
+        using difference_type = std::ptrdiff_t;
+        using reference = T &;
+        using const_reference = const T &;
+        using pointer = T *;
+        using const_pointer = const T *;
+        using iterator = T *;
+        using const_iterator = const T *;
+        using reverse_iterator = std::reverse_iterator<iterator>;
+        using const_reverse_iterator = std::reverse_iterator<const_iterator>;
+
+        static_vector() = default;
+
+        explicit static_vector(size_type n, const T &value = T()) { resize(n, value); }
+
+        static constexpr size_type capacity() { return CAPACITY; }
+
+        size_type size() const { return count; }
+
+        bool empty() const { return count == 0; }
+
+        T *data() { return elements.data(); }
+        const T *data() const { return elements.data(); }
+
+        iterator begin() { return data(); }
+        iterator end() { return data() + count; }
+        const_iterator begin() const { return data(); }
+        const_iterator end() const { return data() + count; }
+        const_iterator cbegin() const { return begin(); }
+        const_iterator cend() const { return end(); }
+        reverse_iterator rbegin() { return reverse_iterator(end()); }
+        reverse_iterator rend() { return reverse_iterator(begin()); }
+        const_reverse_iterator rbegin() const { return const_reverse_iterator(end()); }
+        const_reverse_iterator rend() const { return const_reverse_iterator(begin()); }
+
+        reference operator[](size_type i) { return elements[i]; }
+        const_reference operator[](size_type i) const { return elements[i]; }
+
+        reference at(size_type i) {
+            if (i >= count) throw std::out_of_range("static_vector::at");
+            return elements[i];
+        }
+
+        const_reference at(size_type i) const {
+            if (i >= count) throw std::out_of_range("static_vector::at");
+            return elements[i];
+        }
+
+        reference front() { return elements[0]; }
+        const_reference front() const { return elements[0]; }
+        reference back() { return elements[count - 1]; }
+        const_reference back() const { return elements[count - 1]; }
+
+        void resize(size_type n, const T &value = T()) {
+            if (n > CAPACITY) throw std::length_error("static_vector capacity exceeded");
+            if (n > count) std::fill(elements.begin() + count, elements.begin() + n, value);
+            count = n;
+        }
+
+        void push_back(const T &value) {
+            if (count >= CAPACITY) throw std::length_error("static_vector capacity exceeded");
+            elements[count++] = value;
+        }
+
+        void pop_back() { count--; }
+
+        void clear() { count = 0; }
+
+        template<class IT>
+        void assign(IT first, IT last) {
+            clear();
+            for (; first != last; ++first) push_back(*first);
+        }
+
+        iterator erase(const_iterator pos) { return erase(pos, pos + 1); }
+
+        iterator erase(const_iterator first, const_iterator last) {
+            auto f = begin() + (first - cbegin());
+            auto l = begin() + (last - cbegin());
+            std::move(l, end(), f);
+            count -= (l - f);
+            return f;
+        }
+
+        bool operator==(const static_vector &other) const {
+            return std::equal(begin(), end(), other.begin(), other.end());
+        }
+
+        auto operator<=>(const static_vector &other) const {
+            return std::lexicographical_compare_three_way(begin(), end(), other.begin(), other.end());
+        }
+
+    private:
+        std::array<T, CAPACITY> elements{};
+        std::uint32_t count = 0;
+    };
+
+} // mhe
+
+#endif //MHE_STATIC_VECTOR_H
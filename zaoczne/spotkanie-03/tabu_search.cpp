@@ -0,0 +1,226 @@
+#include "tabu_search.h"
+#include "local_search.h"
+#include "moves.h"
+#include "two_level_tour.h"
+
+#include <algorithm>
+#include <initializer_list>
+#include <memory>
+#include <utility>
+#include <vector>
+
+namespace mhe {
+
+    namespace {
+        const double improvement_eps = 1e-10;
+
+        struct tabu_move_t {
+            enum type_t {
+                none, swap, two_opt, or_opt
+            } type = none;
+            /// swap: the cities a and c; 2-opt: exchange(a, b, c, d); Or-opt: the segment a..b goes between c and d
+            int a, b, c, d;
+            bool reversed;
+            double delta;
+        };
+
+        template<class PROBLEM, class TOUR>
+        class tabu_search_t {
+        public:
+            tabu_search_t(const PROBLEM &p_, TOUR &t_, const tabu_search_config_t &config_) :
+                    p(p_), t(t_), n(t_.size()), config(config_),
+                    tabu_other(2 * t_.size(), -1), tabu_until(2 * t_.size(), 0) {
+                candidates = p.candidates ? p.candidates : p.nearest_candidates(default_candidates);
+            }
+
+            /**
+             * @param start_length the tour length at the start, for the gap in config.stop
+             * @return the change of the tour length from the start to the best tour
+             */
+            double run(double start_length, std::mt19937 &rgen) {
+                std::uniform_int_distribution<int> random_city(0, n - 1);
+                double current = 0;
+                double best = 0;
+                bool at_best = true;
+                for (iteration = 0; iteration < config.iterations; iteration++) {
+                    if (config.stop.reached(start_length + best)) break;
+                    found = {};
+                    for (int k = 0; k < config.sample; k++) score_moves(random_city(rgen), current, best);
+                    if (found.type == tabu_move_t::none) continue;
+                    // the best tour is copied only when the search leaves it
+                    if (at_best && (found.delta > -improvement_eps)) {
+                        best_tour.resize(n);
+                        t.copy_to(best_tour.begin());
+                        at_best = false;
+                    }
+                    apply(found);
+                    current += found.delta;
+                    if (current < best - improvement_eps) {
+                        best = current;
+                        at_best = true;
+                    }
+                }
+                if (at_best) {
+                    best_tour.resize(n);
+                    t.copy_to(best_tour.begin());
+                }
+                return best;
+            }
+
+            const std::vector<int> &best() const { return best_tour; }
+
+        private:
+            const PROBLEM &p;
+            TOUR &t;
+            const int n;
+            const tabu_search_config_t &config;
+            std::shared_ptr<const candidate_lists_t> candidates;
+            int iteration = 0;
+            /// the two last removed edges of every city: (city, tabu_other[2 * city + k]) until the iteration
+            std::vector<int> tabu_other;
+            std::vector<int> tabu_until;
+            tabu_move_t found;
+            std::vector<int> best_tour;
+
+            bool is_tabu(int a, int b) const {
+                for (int k = 0; k < 2; k++) {
+                    if ((tabu_other[2 * a + k] == b) && (tabu_until[2 * a + k] > iteration)) return true;
+                    if ((tabu_other[2 * b + k] == a) && (tabu_until[2 * b + k] > iteration)) return true;
+                }
+                return false;
+            }
+
+            void make_tabu(int a, int b) {
+                for (auto [x, y]: {std::pair{a, b}, std::pair{b, a}}) {
+                    int slot = 2 * x + ((tabu_until[2 * x] <= tabu_until[2 * x + 1]) ? 0 : 1);
+                    tabu_other[slot] = y;
+                    tabu_until[slot] = iteration + 1 + config.tenure;
+                }
+            }
+
+            /// keeps the move if it is better than the found one and it does not add a tabu edge
+            void consider(const tabu_move_t &move, std::initializer_list<std::pair<int, int>> added,
+                          double current, double best) {
+                if ((found.type != tabu_move_t::none) && (move.delta >= found.delta)) return;
+                bool aspiration = current + move.delta < best - improvement_eps;
+                if (!aspiration)
+                    for (auto [x, y]: added)
+                        if (is_tabu(x, y)) return;
+                found = move;
+            }
+
+            /// the moves that connect a with its candidates
+            void score_moves(int a, double current, double best) {
+                const int pa = t.prev(a);
+                const int na = t.next(a);
+                // the Or-opt segments a .. last[len - 1], forward
+                int max_len = std::min(or_opt_move::max_len, n - 3);
+                int last[or_opt_move::max_len];
+                int next[or_opt_move::max_len];
+                double removal[or_opt_move::max_len];
+                for (int len = 1; len <= max_len; len++) {
+                    last[len - 1] = (len == 1) ? a : t.next(last[len - 2]);
+                    next[len - 1] = t.next(last[len - 1]);
+                    removal[len - 1] = p.distance(pa, next[len - 1]) - p.distance(pa, a)
+                                       - p.distance(last[len - 1], next[len - 1]);
+                }
+                for (auto it = candidates->begin(a); it != candidates->end(a); ++it) {
+                    const int c = *it;
+                    const int pc = t.prev(c);
+                    const int nc = t.next(c);
+                    const double d_ac = p.distance(a, c);
+                    if (config.two_opt) {
+                        for (auto [b, d]: {std::pair{na, nc}, std::pair{pa, pc}}) {
+                            if ((c == b) || (d == a)) continue;
+                            double delta = d_ac + p.distance(b, d) - p.distance(a, b) - p.distance(c, d);
+                            consider({tabu_move_t::two_opt, a, b, c, d, false, delta}, {{a, c}, {b, d}}, current, best);
+                        }
+                    }
+                    if (config.or_opt) {
+                        for (int len = 1; len <= max_len; len++) {
+                            const int l = last[len - 1];
+                            if ((c == a) || ((len >= 2) && (c == last[1])) || ((len >= 3) && (c == last[2]))) continue;
+                            // c - a ... l - nc
+                            if (c != pa) {
+                                double delta = removal[len - 1] + d_ac + p.distance(l, nc) - p.distance(c, nc);
+                                consider({tabu_move_t::or_opt, a, l, c, nc, false, delta}, {{pa, next[len - 1]}, {c, a}, {l, nc}},
+                                         current, best);
+                            }
+                            // pc - l ... a - c
+                            if (c != next[len - 1]) {
+                                double delta = removal[len - 1] + p.distance(pc, l) + d_ac - p.distance(pc, c);
+                                consider({tabu_move_t::or_opt, a, l, pc, c, true, delta}, {{pa, next[len - 1]}, {pc, l}, {a, c}},
+                                         current, best);
+                            }
+                        }
+                    }
+                    // the swap of a and c, when their neighbourhoods do not overlap
+                    if (config.swap && (c != na) && (c != pa) && (nc != pa) && (pc != na)) {
+                        double delta = p.distance(pa, c) + p.distance(c, na) + p.distance(pc, a) + p.distance(a, nc)
+                                       - p.distance(pa, a) - p.distance(a, na) - p.distance(pc, c) - p.distance(c, nc);
+                        consider({tabu_move_t::swap, a, -1, c, -1, false, delta}, {{pa, c}, {c, na}, {pc, a}, {a, nc}},
+                                 current, best);
+                    }
+                }
+            }
+
+            void apply(const tabu_move_t &m) {
+                switch (m.type) {
+                    case tabu_move_t::two_opt:
+                        make_tabu(m.a, m.b);
+                        make_tabu(m.c, m.d);
+                        exchange(t, m.a, m.b, m.c, m.d);
+                        break;
+                    case tabu_move_t::or_opt:
+                        make_tabu(t.prev(m.a), m.a);
+                        make_tabu(m.b, t.next(m.b));
+                        make_tabu(m.c, m.d);
+                        move_segment(t, m.a, m.b, m.c, m.d, m.reversed);
+                        break;
+                    case tabu_move_t::swap: {
+                        const int pa = t.prev(m.a);
+                        const int na = t.next(m.a);
+                        for (int x: {pa, na, t.prev(m.c), t.next(m.c)}) {
+                            make_tabu(x, ((x == pa) || (x == na)) ? m.a : m.c);
+                        }
+                        // a goes next to c, then c goes to the place of a
+                        move_segment(t, m.a, m.a, m.c, t.next(m.c), false);
+                        if (t.next(pa) == na) move_segment(t, m.c, m.c, pa, na, false);
+                        else move_segment(t, m.c, m.c, na, pa, false);
+                        break;
+                    }
+                    case tabu_move_t::none:
+                        break;
+                }
+            }
+        };
+
+        template<class TOUR, class SOLUTION>
+        double move_tabu_search_on(SOLUTION &s, const tabu_search_config_t &config, std::mt19937 &rgen) {
+            const SOLUTION &read_only = s;
+            TOUR tour(read_only.begin(), read_only.end());
+            tabu_search_t search(*s.problem, tour, config);
+            // the goal is evaluated only when the gap to the bound is checked
+            double change = search.run((config.stop.lower_bound > 0) ? s.goal() : 0.0, rgen);
+            if (change == 0.0) return change;
+            auto goal_before = s.cached_goal();
+            std::copy(search.best().begin(), search.best().end(), s.begin());
+            if (goal_before) s.set_cached_goal(*goal_before + change);
+            return change;
+        }
+    }
+
+    template<class SOLUTION>
+    double move_tabu_search(SOLUTION &s, const tabu_search_config_t &config, std::mt19937 &rgen) {
+        if (s.size() < 5) return 0.0;
+        if (s.size() >= two_level_tour_min_cities) return move_tabu_search_on<two_level_tour_t>(s, config, rgen);
+        return move_tabu_search_on<array_tour_t>(s, config, rgen);
+    }
+
+    template double move_tabu_search(solution_t &, const tabu_search_config_t &, std::mt19937 &);
+    template double move_tabu_search(solution16_t &, const tabu_search_config_t &, std::mt19937 &);
+    template double move_tabu_search(solution32_t &, const tabu_search_config_t &, std::mt19937 &);
+    template double move_tabu_search(inline_solution_t &, const tabu_search_config_t &, std::mt19937 &);
+    template double move_tabu_search(tsplib_solution_t &, const tabu_search_config_t &, std::mt19937 &);
+
+} // mhe
@@ -0,0 +1,45 @@
+#ifndef MHE_TABU_SEARCH_H
+#define MHE_TABU_SEARCH_H
+
+#include "lower_bound.h"
+#include "solution_t.h"
+
+#include <random>
+
+namespace mhe {
+
+    /// parameters of move_tabu_search
+    struct tabu_search_config_t {
+        int iterations = 100000; ///< the number of applied moves
+        int tenure = 10; ///< for how many iterations a removed edge cannot be added back
+        int sample = 16; ///< base cities checked in every iteration, the bounded candidate list
+        bool swap = true;
+        bool two_opt = true;
+        bool or_opt = true;
+        stop_condition_t stop; ///< the time limit and the gap to the lower bound, besides iterations
+    };
+
+    /**
+     * Tabu search over the swap, 2-opt and Or-opt (segments of 1-3 cities) moves. In every
+     * iteration the moves from a few random cities to their nearest neighbours are scored
+     * with O(1) deltas, and the best allowed one is applied, even if it makes the tour longer.
+     *
+     * The tabu list is attribute based: a removed edge cannot be added back for tenure
+     * iterations, unless the move gives a new best tour (aspiration). Only the two last
+     * removed edges of every city are kept, in flat arrays.
+     *
+     * s becomes the best tour that was found.
+     * @return the change of goal()
+     */
+    template<class SOLUTION>
+    double move_tabu_search(SOLUTION &s, const tabu_search_config_t &config, std::mt19937 &rgen);
+
+    extern template double move_tabu_search(solution_t &, const tabu_search_config_t &, std::mt19937 &);
+    extern template double move_tabu_search(solution16_t &, const tabu_search_config_t &, std::mt19937 &);
+    extern template double move_tabu_search(solution32_t &, const tabu_search_config_t &, std::mt19937 &);
+    extern template double move_tabu_search(inline_solution_t &, const tabu_search_config_t &, std::mt19937 &);
+    extern template double move_tabu_search(tsplib_solution_t &, const tabu_search_config_t &, std::mt19937 &);
+
+} // mhe
+
+#endif //MHE_TABU_SEARCH_H
@@ -0,0 +1,162 @@
+#include "tour_length.h"
+
+#include <algorithm>
+#include <cmath>
+
+#if (defined(__x86_64__) || defined(__i386__)) && (defined(__GNUC__) || defined(__clang__))
+#define MHE_X86_DISPATCH 1
+#include <immintrin.h>
+#endif
+
+namespace mhe {
+
+    namespace {
+        template<class F>
+        double scalar_tour_length(const coordinates_soa_t<F> &c, const int *t, int n, int from = 0) {
+            const F *x = c.x.data();
+            const F *y = c.y.data();
+            double sum = 0;
+            for (int i = from; i < n - 1; i++) {
+                double dx = x[t[i + 1]] - x[t[i]];
+                double dy = y[t[i + 1]] - y[t[i]];
+                sum += std::sqrt(dx * dx + dy * dy);
+            }
+            return sum;
+        }
+
+        template<class F>
+        double closing_edge(const coordinates_soa_t<F> &c, const int *t, int n) {
+            double dx = c.x[t[0]] - c.x[t[n - 1]];
+            double dy = c.y[t[0]] - c.y[t[n - 1]];
+            return std::sqrt(dx * dx + dy * dy);
+        }
+
+#ifdef MHE_X86_DISPATCH
+        __attribute__((target("avx2,fma")))
+        double avx2_tour_length(const coordinates_soa_t<double> &c, const int *t, int n) {
+            const double *x = c.x.data();
+            const double *y = c.y.data();
+            __m256d acc = _mm256_setzero_pd();
+            int i = 0;
+            for (; i + 4 < n; i += 4) {
+                __m128i a = _mm_loadu_si128((const __m128i *) (t + i));
+                __m128i b = _mm_loadu_si128((const __m128i *) (t + i + 1));
+                __m256d dx = _mm256_sub_pd(_mm256_i32gather_pd(x, b, 8), _mm256_i32gather_pd(x, a, 8));
+                __m256d dy = _mm256_sub_pd(_mm256_i32gather_pd(y, b, 8), _mm256_i32gather_pd(y, a, 8));
+                acc = _mm256_add_pd(acc, _mm256_sqrt_pd(_mm256_fmadd_pd(dx, dx, _mm256_mul_pd(dy, dy))));
+            }
+            alignas(32) double lanes[4];
+            _mm256_store_pd(lanes, acc);
+            return lanes[0] + lanes[1] + lanes[2] + lanes[3] + scalar_tour_length(c, t, n, i);
+        }
+
+        __attribute__((target("avx2,fma")))
+        double avx2_tour_length(const coordinates_soa_t<float> &c, const int *t, int n) {
+            const float *x = c.x.data();
+            const float *y = c.y.data();
+            __m256d acc = _mm256_setzero_pd();
+            int i = 0;
+            for (; i + 8 < n; i += 8) {
+                __m256i a = _mm256_loadu_si256((const __m256i *) (t + i));
+                __m256i b = _mm256_loadu_si256((const __m256i *) (t + i + 1));
+                __m256 dx = _mm256_sub_ps(_mm256_i32gather_ps(x, b, 4), _mm256_i32gather_ps(x, a, 4));
+                __m256 dy = _mm256_sub_ps(_mm256_i32gather_ps(y, b, 4), _mm256_i32gather_ps(y, a, 4));
+                __m256 l = _mm256_sqrt_ps(_mm256_fmadd_ps(dx, dx, _mm256_mul_ps(dy, dy)));
+                acc = _mm256_add_pd(acc, _mm256_cvtps_pd(_mm256_castps256_ps128(l)));
+                acc = _mm256_add_pd(acc, _mm256_cvtps_pd(_mm256_extractf128_ps(l, 1)));
+            }
+            alignas(32) double lanes[4];
+            _mm256_store_pd(lanes, acc);
+            return lanes[0] + lanes[1] + lanes[2] + lanes[3] + scalar_tour_length(c, t, n, i);
+        }
+
+        __attribute__((target("avx512f")))
+        double avx512_tour_length(const coordinates_soa_t<double> &c, const int *t, int n) {
+            const double *x = c.x.data();
+            const double *y = c.y.data();
+            __m512d acc = _mm512_setzero_pd();
+            int i = 0;
+            for (; i + 8 < n; i += 8) {
+                __m256i a = _mm256_loadu_si256((const __m256i *) (t + i));
+                __m256i b = _mm256_loadu_si256((const __m256i *) (t + i + 1));
+                __m512d dx = _mm512_sub_pd(_mm512_i32gather_pd(b, x, 8), _mm512_i32gather_pd(a, x, 8));
+                __m512d dy = _mm512_sub_pd(_mm512_i32gather_pd(b, y, 8), _mm512_i32gather_pd(a, y, 8));
+                acc = _mm512_add_pd(acc, _mm512_sqrt_pd(_mm512_fmadd_pd(dx, dx, _mm512_mul_pd(dy, dy))));
+            }
+            return _mm512_reduce_add_pd(acc) + scalar_tour_length(c, t, n, i);
+        }
+
+        __attribute__((target("avx512f")))
+        double avx512_tour_length(const coordinates_soa_t<float> &c, const int *t, int n) {
+            const float *x = c.x.data();
+            const float *y = c.y.data();
+            __m512d acc = _mm512_setzero_pd();
+            int i = 0;
+            for (; i + 16 < n; i += 16) {
+                __m512i a = _mm512_loadu_si512((const void *) (t + i));
+                __m512i b = _mm512_loadu_si512((const void *) (t + i + 1));
+                __m512 dx = _mm512_sub_ps(_mm512_i32gather_ps(b, x, 4), _mm512_i32gather_ps(a, x, 4));
+                __m512 dy = _mm512_sub_ps(_mm512_i32gather_ps(b, y, 4), _mm512_i32gather_ps(a, y, 4));
+                __m512 l = _mm512_sqrt_ps(_mm512_fmadd_ps(dx, dx, _mm512_mul_ps(dy, dy)));
+                __m256 low = _mm512_castps512_ps256(l);
+                __m256 high = _mm256_castpd_ps(_mm512_extractf64x4_pd(_mm512_castps_pd(l), 1));
+                acc = _mm512_add_pd(acc, _mm512_cvtps_pd(low));
+                acc = _mm512_add_pd(acc, _mm512_cvtps_pd(high));
+            }
+            return _mm512_reduce_add_pd(acc) + scalar_tour_length(c, t, n, i);
+        }
+#endif
+
+        template<class F>
+        double dispatch_tour_length(const coordinates_soa_t<F> &c, const int *t, int n, simd_level level) {
+            if (n < 2) return 0.0;
+            level = std::min(level, detected_simd_level());
+            double sum;
+            switch (level) {
+#ifdef MHE_X86_DISPATCH
+                case simd_level::avx512:
+                    sum = avx512_tour_length(c, t, n);
+                    break;
+                case simd_level::avx2:
+                    sum = avx2_tour_length(c, t, n);
+                    break;
+#endif
+                default:
+                    sum = scalar_tour_length(c, t, n);
+            }
+            return sum + closing_edge(c, t, n);
+        }
+    }
+
+    simd_level detected_simd_level() {
+        static const simd_level level = [] {
+#ifdef MHE_X86_DISPATCH
+            __builtin_cpu_init();
+            if (__builtin_cpu_supports("avx512f")) return simd_level::avx512;
+            if (__builtin_cpu_supports("avx2") && __builtin_cpu_supports("fma")) return simd_level::avx2;
+#endif
+            return simd_level::scalar;
+        }();
+        return level;
+    }
+
+    const char *simd_level_name(simd_level level) {
+        switch (level) {
+            case simd_level::avx512:
+                return "avx512";
+            case simd_level::avx2:
+                return "avx2";
+            default:
+                return "scalar";
+        }
+    }
+
+    double tour_length(const coordinates_soa_t<double> &c, const int *tour, int n, simd_level level) {
+        return dispatch_tour_length(c, tour, n, level);
+    }
+
+    double tour_length(const coordinates_soa_t<float> &c, const int *tour, int n, simd_level level) {
+        return dispatch_tour_length(c, tour, n, level);
+    }
+
+} // mhe
@@ -0,0 +1,55 @@
+#ifndef MHE_TOUR_LENGTH_H
+#define MHE_TOUR_LENGTH_H
+
+#include "aligned_allocator.h"
+#include "vec2d.h"
+
+#include <vector>
+
+namespace mhe {
+
+    /**
+     * Coordinates of cities as separate x[] and y[] arrays (structure of arrays),
+     * in double or single precision.
+     */
+    template<class F>
+    struct coordinates_soa_t {
+        aligned_vector<F> x;
+        aligned_vector<F> y;
+
+        coordinates_soa_t() = default;
+
+        explicit coordinates_soa_t(const std::vector<vec2d> &cities) : x(cities.size()), y(cities.size()) {
+            for (std::size_t i = 0; i < cities.size(); i++) {
+                x[i] = cities[i][0];
+                y[i] = cities[i][1];
+            }
+        }
+
+        std::size_t size() const { return x.size(); }
+    };
+
+    enum class simd_level {
+        scalar, avx2, avx512
+    };
+
+    /// the best instruction set supported by this CPU, checked once at runtime
+    simd_level detected_simd_level();
+
+    const char *simd_level_name(simd_level level);
+
+    /**
+     * Length of the closed tour of n cities. The coordinates are gathered by the tour
+     * indices, and the closing edge is added outside of the vectorized loop.
+     * The kernel is chosen at runtime; a level above detected_simd_level() is lowered.
+     */
+    double tour_length(const coordinates_soa_t<double> &c, const int *tour, int n,
+                       simd_level level = detected_simd_level());
+
+    /// single precision coordinates, the sum is accumulated in double precision
+    double tour_length(const coordinates_soa_t<float> &c, const int *tour, int n,
+                       simd_level level = detected_simd_level());
+
+} // mhe
+
+#endif //MHE_TOUR_LENGTH_H
@@ -0,0 +1,92 @@
+// Compares the tour length kernels with solution_t::goal().
+// Usage: tour_length_benchmark [-edges 100000000]
+
+#include "tp_args.hpp"
+#include "solution_t.h"
+#include "tour_length.h"
+
+#include <chrono>
+#include <functional>
+#include <iomanip>
+#include <iostream>
+#include <random>
+#include <string>
+
+using namespace mhe;
+
+/// the goal() as it was before: modulo and sqrt on every edge
+double reference_goal(const solution_t &t)
+{
+    double sum_distance = 0;
+    auto& p = *t.problem;
+    for (int i = 0; i < t.size(); i++)
+        sum_distance += len(p[t[i]] - p[t[(i + 1) % t.size()]]);
+    return sum_distance;
+}
+
+/// goal() without the cache, so that every call evaluates the whole tour
+template <class SOLUTION>
+double uncached_goal(SOLUTION& solution)
+{
+    solution.invalidate_goal();
+    return solution.goal();
+}
+
+double measure(const std::string& name, int n, long total_edges, std::function<double()> f, double reference_time)
+{
+    long repeats = std::max(1L, total_edges / n);
+    volatile double result = 0;
+    auto start = std::chrono::steady_clock::now();
+    for (long r = 0; r < repeats; r++)
+        result = result + f();
+    auto end = std::chrono::steady_clock::now();
+    double ns_per_edge = std::chrono::duration<double, std::nano>(end - start).count() / (repeats * n);
+    std::cout << std::setw(8) << n << " " << std::setw(22) << name << " " << std::setw(10) << std::fixed
+              << std::setprecision(3) << ns_per_edge << " ns/edge";
+    if (reference_time > 0) std::cout << "  x" << std::setprecision(2) << reference_time / ns_per_edge;
+    std::cout << std::endl;
+    return ns_per_edge;
+}
+
+int main(int argc, char** argv)
+{
+    using namespace tp::args;
+    auto total_edges = arg(argc, argv, "edges", 100000000, "edges summed by every kernel");
+    auto help = arg(argc, argv, "help", false, "help screen");
+    if (help) {
+        args_info(std::cout);
+        return 0;
+    }
+    std::mt19937 rgen(2023);
+    std::cout << "detected: " << simd_level_name(detected_simd_level()) << std::endl;
+    for (int n : {30, 1000, 100000}) {
+        problem_t problem = generate_problem(n, 10, 10, rgen);
+        auto solution = solution_t::random_solution(register_problem(problem), rgen);
+        coordinates_soa_t<double> soa(problem);
+        coordinates_soa_t<float> soa_f(problem);
+
+        double ref = measure("reference goal()", n, total_edges, [&] { return reference_goal(solution); }, 0);
+        measure("goal() on the fly", n, total_edges, [&] { return uncached_goal(solution); }, ref);
+        problem.precompute_coordinates();
+        solution.problem = register_problem(problem);
+        measure("goal() SoA", n, total_edges, [&] { return uncached_goal(solution); }, ref);
+        if (problem.precompute_distances()) {
+            solution.problem = register_problem(problem);
+            measure("goal() matrix", n, total_edges, [&] { return uncached_goal(solution); }, ref);
+        }
+        tsplib_problem_t integer_problem(problem.begin(), problem.end());
+        if (integer_problem.precompute_distances()) {
+            auto integer_solution = tsplib_solution_t::for_problem(register_problem(integer_problem));
+            integer_solution.assign(solution.cbegin(), solution.cend());
+            measure("goal() int32 matrix", n, total_edges, [&] { return uncached_goal(integer_solution); }, ref);
+        }
+        for (auto level : {simd_level::scalar, simd_level::avx2, simd_level::avx512}) {
+            if (level > detected_simd_level()) continue;
+            measure(std::string("soa double ") + simd_level_name(level), n, total_edges,
+                [&] { return tour_length(soa, solution.data(), n, level); }, ref);
+            measure(std::string("soa float ") + simd_level_name(level), n, total_edges,
+                [&] { return tour_length(soa_f, solution.data(), n, level); }, ref);
+        }
+    }
+    return 0;
+}
@@ -0,0 +1,123 @@
+#include "two_level_tour.h"
+
+#include <cmath>
+
+namespace mhe {
+
+    void two_level_tour_t::rebuild() {
+        const int n = cities.size();
+        if (n == 0) return;
+        if (!segments.empty()) {
+            std::vector<int> order(n);
+            copy_to(order.begin());
+            cities.swap(order);
+        }
+        const int group = std::max(1, (int) std::sqrt((double) n));
+        const int count = (n + group - 1) / group;
+        segments.resize(count);
+        for (int s = 0; s < count; s++)
+            segments[s] = {s * group, std::min(n, (s + 1) * group), false, s * rank_gap, (s + 1) % count,
+                           (s + count - 1) % count};
+        slot.resize(n);
+        segment_of.resize(n);
+        for (int i = 0; i < n; i++) {
+            slot[cities[i]] = i;
+            segment_of[cities[i]] = i / group;
+        }
+        max_segments = 8 * count + 2;
+    }
+
+    void two_level_tour_t::renumber() {
+        int s = 0;
+        for (int rank = 0; rank < segments.size(); rank++, s = segments[s].next) segments[s].rank = rank * rank_gap;
+    }
+
+    void two_level_tour_t::split_before(int a) {
+        if (offset(a) == 0) return;
+        const int index = segment_of[a];
+        // the part from a gets the rank between the segment and the next one
+        auto gap = [&]() { return segments[segments[index].next].rank - segments[index].rank; };
+        if ((gap() > 0) && (gap() < 2)) renumber();
+        const segment_t s = segments[index];
+        // the part before a and the part from a, in the orientation of the segment
+        segment_t before = s;
+        segment_t from = s;
+        if (!s.reversed) {
+            before.end = from.begin = slot[a];
+        } else {
+            from.end = before.begin = slot[a] + 1;
+        }
+        // the smaller part gets the new segment, so fewer cities have to be updated
+        const int added = segments.size();
+        const bool move_before = (before.end - before.begin) < (from.end - from.begin);
+        const int before_index = move_before ? added : index;
+        const int from_index = move_before ? index : added;
+        before.next = from_index;
+        from.prev = before_index;
+        from.rank = (gap() > 0) ? s.rank + gap() / 2 : s.rank + 1;
+        if (s.next == index) {
+            before.prev = from_index;
+            from.next = before_index;
+        }
+        segments.push_back({});
+        segments[before_index] = before;
+        segments[from_index] = from;
+        if (s.next != index) {
+            segments[s.prev].next = before_index;
+            segments[s.next].prev = from_index;
+        }
+        auto &moved = segments[added];
+        for (int i = moved.begin; i < moved.end; i++) segment_of[cities[i]] = added;
+    }
+
+    void two_level_tour_t::reverse_segments(int first, int last) {
+        std::vector<int> run;
+        std::vector<int> ranks;
+        for (int s = first;; s = segments[s].next) {
+            run.push_back(s);
+            ranks.push_back(segments[s].rank);
+            if (s == last) break;
+        }
+        const int before = segments[first].prev;
+        const int after = segments[last].next;
+        const int m = run.size();
+        // the positions in the ring keep their ranks, the segments change places
+        for (int k = 0; k < m; k++) {
+            auto &s = segments[run[m - 1 - k]];
+            s.reversed = !s.reversed;
+            s.rank = ranks[k];
+            s.prev = (k == 0) ? before : run[m - k];
+            s.next = (k + 1 == m) ? after : run[m - 2 - k];
+        }
+        segments[before].next = run.back();
+        segments[after].prev = run.front();
+    }
+
+    void two_level_tour_t::flip(int a, int b, int c, int d) {
+        // a single city, or the whole tour, keeps the cyclic order
+        if ((b == c) || (d == b)) return;
+        if ((segment_of[b] == segment_of[c]) && (offset(b) <= offset(c))) {
+            int i = std::min(slot[b], slot[c]);
+            int j = std::max(slot[b], slot[c]);
+            for (; i < j; i++, j--) {
+                std::swap(cities[i], cities[j]);
+                slot[cities[i]] = i;
+                slot[cities[j]] = j;
+            }
+            return;
+        }
+        // b .. c and d .. a become runs of whole segments, the shorter one is reversed
+        split_before(b);
+        split_before(d);
+        int first = segment_of[b];
+        int other = segment_of[d];
+        while ((first != segment_of[c]) && (other != segment_of[a])) {
+            first = segments[first].next;
+            other = segments[other].next;
+        }
+        if (first == segment_of[c]) reverse_segments(segment_of[b], segment_of[c]);
+        else reverse_segments(segment_of[d], segment_of[a]);
+        if (segments.size() > max_segments) rebuild();
+    }
+
+} // mhe
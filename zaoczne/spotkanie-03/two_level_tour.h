@@ -0,0 +1,189 @@
+#ifndef MHE_TWO_LEVEL_TOUR_H
+#define MHE_TWO_LEVEL_TOUR_H
+
+#include <algorithm>
+#include <vector>
+
+namespace mhe {
+
+    /// from that size the O(sqrt(n)) flips of two_level_tour_t beat the O(n) array reversals
+    constexpr int two_level_tour_min_cities = 5000;
+
+    /**
+     * Tour as the array of cities and the position of every city. This is the simple
+     * version of the interface used by the local search:
+     * - next(a), prev(a) - the neighbours of a in the current orientation,
+     * - between(a, b, c) - true if b is on the way from a forward to c,
+     * - flip(a, b, c, d) - for b = next(a) and d = next(c), replaces the edges (a, b)
+     *   and (c, d) with (a, c) and (b, d).
+     * flip reverses the shorter of the two paths, so the orientation of the whole tour
+     * can change; only the cyclic order of the cities is kept. It costs O(n).
+     */
+    class array_tour_t {
+    public:
+        template<class IT>
+        array_tour_t(IT first, IT last) : order(first, last), position(order.size()) {
+            for (int i = 0; i < order.size(); i++) position[order[i]] = i;
+        }
+
+        int size() const { return order.size(); }
+
+        int next(int a) const {
+            int i = position[a] + 1;
+            return order[(i == order.size()) ? 0 : i];
+        }
+
+        int prev(int a) const {
+            int i = position[a];
+            return order[(i == 0) ? order.size() - 1 : i - 1];
+        }
+
+        bool between(int a, int b, int c) const {
+            int i = position[a], j = position[b], k = position[c];
+            return (i <= k) ? ((i <= j) && (j <= k)) : ((j >= i) || (j <= k));
+        }
+
+        void flip(int a, int b, int c, int d) {
+            const int n = order.size();
+            int i = position[b];
+            int j = position[c];
+            int length = (j - i + n) % n + 1;
+            if (2 * length > n) {
+                i = position[d];
+                j = position[a];
+                length = n - length;
+            }
+            for (int k = 0; k < length / 2; k++) {
+                int l = (i + k) % n;
+                int r = (j - k + n) % n;
+                std::swap(order[l], order[r]);
+                position[order[l]] = l;
+                position[order[r]] = r;
+            }
+        }
+
+        /// the cities from a in the forward direction
+        template<class OUT>
+        void copy_to(OUT out) const {
+            std::copy(order.begin(), order.end(), out);
+        }
+
+    private:
+        std::vector<int> order;
+        std::vector<int> position;
+    };
+
+    /**
+     * Two-level doubly-linked list (Fredman et al.). The tour is split into about sqrt(n)
+     * segments. Each segment is a range of the city array with a reversal bit, and the
+     * segments form a ring. flip() splits at most two segments and reverses the order of
+     * the segments between them, flipping their bits, so it costs O(sqrt(n)) instead of
+     * O(n). next, prev and between are O(1). The interface is the same as array_tour_t.
+     */
+    class two_level_tour_t {
+    public:
+        template<class IT>
+        two_level_tour_t(IT first, IT last) : cities(first, last) {
+            rebuild();
+        }
+
+        int size() const { return cities.size(); }
+
+        int next(int a) const {
+            auto &s = segments[segment_of[a]];
+            int i = slot[a];
+            if (!s.reversed) return (i + 1 < s.end) ? cities[i + 1] : first_of(s.next);
+            return (i > s.begin) ? cities[i - 1] : first_of(s.next);
+        }
+
+        int prev(int a) const {
+            auto &s = segments[segment_of[a]];
+            int i = slot[a];
+            if (!s.reversed) return (i > s.begin) ? cities[i - 1] : last_of(s.prev);
+            return (i + 1 < s.end) ? cities[i + 1] : last_of(s.prev);
+        }
+
+        bool between(int a, int b, int c) const {
+            long i = key(a), j = key(b), k = key(c);
+            return (i <= k) ? ((i <= j) && (j <= k)) : ((j >= i) || (j <= k));
+        }
+
+        void flip(int a, int b, int c, int d);
+
+        template<class OUT>
+        void copy_to(OUT out) const {
+            if (segments.empty()) return;
+            int s = 0;
+            do {
+                auto &segment = segments[s];
+                if (segment.reversed) out = std::reverse_copy(cities.begin() + segment.begin, cities.begin() + segment.end, out);
+                else out = std::copy(cities.begin() + segment.begin, cities.begin() + segment.end, out);
+                s = segment.next;
+            } while (s != 0);
+        }
+
+    private:
+        struct segment_t {
+            int begin; ///< the range of slots in cities
+            int end;
+            bool reversed;
+            int rank; ///< increasing along the ring, with gaps for the new segments
+            int next;
+            int prev;
+        };
+
+        std::vector<int> cities; ///< the cities of every segment are in one range of this array
+        std::vector<int> slot; ///< the index of every city in cities
+        std::vector<int> segment_of;
+        std::vector<segment_t> segments;
+        int max_segments = 0; ///< more segments than that, after splits, and the list is rebuilt
+        static constexpr int rank_gap = 64;
+
+        int first_of(int s) const { return segments[s].reversed ? cities[segments[s].end - 1] : cities[segments[s].begin]; }
+
+        int last_of(int s) const { return segments[s].reversed ? cities[segments[s].begin] : cities[segments[s].end - 1]; }
+
+        /// the position of the city in the current orientation of its segment
+        int offset(int a) const {
+            auto &s = segments[segment_of[a]];
+            return s.reversed ? s.end - 1 - slot[a] : slot[a] - s.begin;
+        }
+
+        /// increasing along the tour, except at one place of the ring
+        long key(int a) const { return (long) segments[segment_of[a]].rank * cities.size() + offset(a); }
+
+        void rebuild();
+
+        /// spreads the ranks again when there is no free rank for a new segment
+        void renumber();
+
+        /// makes a the first city of its segment
+        void split_before(int a);
+
+        /// reverses the whole segments from first to last, forward along the ring
+        void reverse_segments(int first, int last);
+    };
+
+    /// replaces the edges (a, b) and (c, d) with (a, c) and (b, d), b and d on the same side
+    template<class TOUR>
+    void exchange(TOUR &t, int a, int b, int c, int d) {
+        if (t.next(a) == b) t.flip(a, b, c, d);
+        else t.flip(b, a, d, c);
+    }
+
+    /**
+     * Moves the segment first..last (forward) between c and e = next(c), reversed or not.
+     * It is done by two or three 2-opt exchanges.
+     */
+    template<class TOUR>
+    void move_segment(TOUR &t, int first, int last, int c, int e, bool reversed) {
+        int prev = t.prev(first);
+        int next = t.next(last);
+        exchange(t, prev, first, c, e); // prev c .. next last .. first e
+        exchange(t, prev, c, next, last); // prev next .. c last .. first e
+        if (!reversed) exchange(t, c, last, first, e); // c first .. last e
+    }
+
+} // mhe
+
+#endif //MHE_TWO_LEVEL_TOUR_H